@@ -9,16 +9,16 @@
 
 namespace bee::async {
 
-    std::unique_ptr<async> create() {
+    std::unique_ptr<async> create([[maybe_unused]] const async_options& options) {
 #if defined(__linux__)
 #    if defined(BEE_ASYNC_BACKEND_EPOLL)
-        return std::make_unique<async_epoll>();
+        return std::make_unique<async_epoll>(options);
 #    else
-        auto uring = std::make_unique<async_uring>();
+        auto uring = std::make_unique<async_uring>(options);
         if (uring->valid()) {
             return uring;
         }
-        return std::make_unique<async_epoll>();
+        return std::make_unique<async_epoll>(options);
 #    endif
 #else
         return std::make_unique<async>();
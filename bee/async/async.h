@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bee/async/async_types.h>
+#include <bee/async/buffer_pool.h>
 #include <bee/net/endpoint.h>
 #include <bee/net/fd.h>
 #include <bee/net/socket.h>
@@ -27,25 +28,100 @@ namespace bee::async {
 
 #if defined(__linux__)
 
+    // Layout of the kernel's struct statx.  glibc only declares it from
+    // 2.28 and bionic from API 30, so submit_statx fills this instead.
+    struct statx_timestamp {
+        int64_t tv_sec;
+        uint32_t tv_nsec;
+        int32_t reserved;
+    };
+    struct statx_result {
+        uint32_t stx_mask;
+        uint32_t stx_blksize;
+        uint64_t stx_attributes;
+        uint32_t stx_nlink;
+        uint32_t stx_uid;
+        uint32_t stx_gid;
+        uint16_t stx_mode;
+        uint16_t spare0;
+        uint64_t stx_ino;
+        uint64_t stx_size;
+        uint64_t stx_blocks;
+        uint64_t stx_attributes_mask;
+        statx_timestamp stx_atime;
+        statx_timestamp stx_btime;
+        statx_timestamp stx_ctime;
+        statx_timestamp stx_mtime;
+        uint32_t stx_rdev_major;
+        uint32_t stx_rdev_minor;
+        uint32_t stx_dev_major;
+        uint32_t stx_dev_minor;
+        uint64_t spare2[14];
+    };
+    static_assert(sizeof(statx_result) == 256);
+    constexpr uint32_t statx_basic_stats = 0x7ff;  // STATX_BASIC_STATS
+
     class async {
     public:
         virtual ~async()                                                                                                                = default;
-        virtual bool submit_read(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id)                              = 0;
-        virtual bool submit_write(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id)                              = 0;
-        virtual bool submit_accept(net::fd_t listen_fd, uint64_t request_id)                                                            = 0;
-        virtual bool submit_connect(net::fd_t fd, const net::endpoint& ep, uint64_t request_id)                                         = 0;
+        // timeout on read/write/accept/connect is a per-op deadline in ms
+        // (-1 = none); an expired op completes with async_status::timeout.
+        virtual bool submit_read(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id, int timeout = -1)              = 0;
+        virtual bool submit_write(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id, int timeout = -1)             = 0;
+        virtual bool submit_accept(net::fd_t listen_fd, uint64_t request_id, int timeout = -1)                                          = 0;
+        virtual bool submit_accept_multishot(net::fd_t listen_fd, uint64_t request_id)                                                  = 0;
+        virtual bool submit_connect(net::fd_t fd, const net::endpoint& ep, uint64_t request_id, int timeout = -1)                       = 0;
         virtual bool submit_file_read(file_handle::value_type fd, void* buffer, size_t len, int64_t offset, uint64_t request_id)        = 0;
         virtual bool submit_file_write(file_handle::value_type fd, const void* buffer, size_t len, int64_t offset, uint64_t request_id) = 0;
+        virtual bool submit_file_open(const char* path, int flags, int mode, uint64_t request_id)                                       = 0;
+        virtual bool submit_file_close(file_handle::value_type fd, uint64_t request_id)                                                 = 0;
+        virtual bool submit_fsync(file_handle::value_type fd, bool datasync, uint64_t request_id)                                       = 0;
+        // Fills a statx_result; an empty path stats dirfd itself.
+        virtual bool submit_statx(file_handle::value_type dirfd, const char* path, void* statxbuf, uint64_t request_id)                 = 0;
+        virtual bool submit_sendfile(net::fd_t fd, file_handle::value_type file, int64_t offset, uint64_t len, uint64_t request_id)     = 0;
+        // Forwards src to dst until EOF or limit bytes (0 = no limit) and
+        // completes once, like submit_sendfile.
+        virtual bool submit_relay(net::fd_t src, net::fd_t dst, uint64_t limit, uint64_t request_id)                                    = 0;
+        // Fills ep with the sender; buffer and ep must stay valid until the
+        // completion.  A GRO-coalesced receive reports its segment size in
+        // io_completion::buffer_id.
+        virtual bool submit_recvfrom(net::fd_t fd, void* buffer, size_t len, net::endpoint* ep, uint64_t request_id)                    = 0;
+        // Sends to ep, or to the connected peer when ep is nullptr; gso > 0
+        // splits buffer into UDP GSO segments of that size.  Both must stay
+        // valid until the completion.
+        virtual bool submit_sendto(net::fd_t fd, const void* buffer, size_t len, const net::endpoint* ep, int gso, uint64_t request_id) = 0;
         virtual bool submit_poll(net::fd_t fd, uint64_t request_id)                                                                     = 0;
+        virtual bool submit_recv(net::fd_t fd, uint16_t group, uint64_t request_id)                                                     = 0;
+        virtual bool submit_recv_multishot(net::fd_t fd, uint16_t group, uint64_t request_id)                                           = 0;
+        // Completes as async_op::timer after timeout ms, or with
+        // async_status::cancel once cancel_timer(timer_id) takes effect.
+        virtual bool submit_timer(int timeout, uint64_t timer_id, uint64_t request_id)                                                  = 0;
+        // The one call allowed from other threads: queues a completion of
+        // op post carrying request_id (below 2^56) and wakes a blocked wait.
+        // The caller must keep it from racing stop() or the destructor.
+        virtual bool post(uint64_t request_id)                                                                                          = 0;
+        // Counters restart from zero after stop().
+        virtual void stats(async_stats& out)                                                                                            = 0;
+        virtual int create_buffer_pool(size_t buf_size, uint16_t count)                                                                 = 0;
+        virtual buffer_pool* get_buffer_pool(uint16_t group)                                                                            = 0;
+        virtual bool recycle_buffer(uint16_t group, uint16_t bid)                                                                       = 0;
+        virtual bool register_fd(int fd)                                                                                                = 0;
+        virtual void unregister_fd(int fd)                                                                                              = 0;
         virtual int poll(const span<io_completion>& completions)                                                                        = 0;
+        // timeout in ms, -1 for no limit.
         virtual int wait(const span<io_completion>& completions, int timeout)                                                           = 0;
+        // timeout_ns in ns, -1 for no limit.
+        virtual int wait_ns(const span<io_completion>& completions, int64_t timeout_ns)                                                 = 0;
         virtual void stop()                                                                                                             = 0;
         virtual void cancel(net::fd_t fd)                                                                                               = 0;
+        virtual void cancel(net::fd_t fd, async_op op)                                                                                  = 0;
+        // Callers never reuse a timer_id, so a stale one cancels nothing.
+        virtual void cancel_timer(uint64_t timer_id)                                                                                    = 0;
     };
 
 #endif
 
     // Factory function: create the async backend for the current platform.
-    std::unique_ptr<async> create();
+    std::unique_ptr<async> create(const async_options& options = {});
 
 }  // namespace bee::async
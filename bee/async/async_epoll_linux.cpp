@@ -1,33 +1,80 @@
 #include <bee/async/async.h>
 #include <bee/async/async_epoll_linux.h>
+#include <bee/net/bpoll.h>
 #include <bee/net/endpoint.h>
 #include <bee/net/socket.h>
+#include <bee/nonstd/unreachable.h>
+#include <bee/thread/simplethread.h>
+#include <fcntl.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
 
 namespace bee::async {
 
-    async_epoll::async_epoll()
-        : m_epfd(-1) {
+    async_epoll::async_epoll(const async_options& options)
+        : m_epfd(-1)
+        , m_file_threads(options.file_threads ? options.file_threads : kDefaultFileThreads)
+        , m_edge(options.edge_triggered)
+        , m_post_efd(-1)
+        , m_posts(nullptr)
+        , m_file_inflight(0)
+        , m_busy(static_cast<int64_t>(options.busy_poll) * 1000) {
         m_epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (m_epfd >= 0) {
+            m_post_efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (m_post_efd >= 0) {
+                struct epoll_event ev {};
+                ev.events  = EPOLLIN | EPOLLET;
+                ev.data.fd = m_post_efd;
+                if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_post_efd, &ev) != 0) {
+                    close(m_post_efd);
+                    m_post_efd = -1;
+                }
+            }
+        }
     }
 
     async_epoll::~async_epoll() {
         stop();
     }
 
-    // Build combined events mask from fd_state and call epoll_ctl ADD or MOD.
-    bool async_epoll::fd_arm(net::fd_t fd, fd_state& state) {
+    // Events fd waits for: one per armed direction, except the side a relay
+    // is not currently waiting on.
+    static uint32_t fd_events(const async_epoll::fd_state& state) noexcept {
         uint32_t events = 0;
-        if (state.read_op) events |= EPOLLIN;
-        if (state.write_op) events |= EPOLLOUT;
+        if (state.read_op && !(state.read_op->type == async_epoll::pending_op::relay && state.read_op->want_out)) events |= EPOLLIN;
+        if (state.write_op && !(state.write_op->type == async_epoll::pending_op::relay && !state.write_op->want_out)) events |= EPOLLOUT;
+        return events;
+    }
 
+    // Bring the epoll registration of fd in line with state: ADD, MOD or DEL.
+    // An edge-triggered registration already covers both directions.
+    // Returns false on epoll_ctl failure.
+    static bool fd_update(int epfd, async_stats& stats, net::fd_t fd, async_epoll::fd_state& state) {
+        if (state.events & EPOLLET) {
+            return true;
+        }
+        uint32_t events = fd_events(state);
         if (events == state.events) {
             return true;
         }
+        stats.ctl_calls++;
+        if (events == 0) {
+            epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+            state.events = 0;
+            return true;
+        }
 
         struct epoll_event ev;
         memset(&ev, 0, sizeof(ev));
@@ -35,13 +82,76 @@ namespace bee::async {
         ev.data.fd = fd;
 
         int op = (state.events == 0) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
-        if (epoll_ctl(m_epfd, op, fd, &ev) != 0) {
+        if (epoll_ctl(epfd, op, fd, &ev) != 0) {
             return false;
         }
         state.events = events;
         return true;
     }
 
+    // Build combined events mask from fd_state and call epoll_ctl ADD or MOD.
+    // In edge-triggered mode an op armed on a direction known to be ready
+    // runs from the cache; any other has to wait for an edge and confirms
+    // the registration first.
+    bool async_epoll::fd_arm(net::fd_t fd, fd_state& state, bool is_write) {
+        if (!m_edge) {
+            return fd_update(m_epfd, m_stats, fd, state);
+        }
+        if ((state.events & EPOLLET) && (state.ready & (is_write ? EPOLLOUT : EPOLLIN))) {
+            return true;
+        }
+        return fd_confirm(fd, state);
+    }
+
+    // Edge-triggered: an op on fd is about to wait for an edge.  Closing a
+    // socket without cancel silently drops it from the epoll set, and a new
+    // socket reusing the number would never report one, so register again
+    // unless ADD answers EEXIST for a registration still in place.
+    bool async_epoll::fd_confirm(net::fd_t fd, fd_state& state) {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events  = EPOLLIN | EPOLLOUT | EPOLLET;
+        ev.data.fd = fd;
+        m_stats.ctl_calls++;
+        if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            if (errno != EEXIST) return false;
+            if (state.events & EPOLLET) return true;
+            // The number was recycled while a dup kept the old file registered.
+            m_stats.ctl_calls++;
+            if (epoll_ctl(m_epfd, EPOLL_CTL_MOD, fd, &ev) != 0) return false;
+        }
+        // A fresh registration reports the current readiness as an edge.
+        state.events = ev.events;
+        state.ready  = 0;
+        return true;
+    }
+
+    void async_epoll::fd_forget(net::fd_t fd) {
+        size_t idx = static_cast<size_t>(fd);
+        if (fd < 0 || idx >= m_fd_states.size()) return;
+        auto& state = m_fd_states[idx];
+        if (state.read_op || state.write_op || !(state.events & EPOLLET)) return;
+        m_stats.ctl_calls++;
+        epoll_ctl(m_epfd, EPOLL_CTL_DEL, fd, nullptr);
+        state = fd_state {};
+    }
+
+    // Edge-triggered: fd was just created by accept or connect, so whatever
+    // was recorded under its number belonged to a file closed without cancel.
+    static void fd_renew(std::vector<async_epoll::fd_state>& fd_states, net::fd_t fd) noexcept {
+        size_t idx = static_cast<size_t>(fd);
+        if (fd < 0 || idx >= fd_states.size()) return;
+        auto& state = fd_states[idx];
+        if (state.read_op || state.write_op) return;
+        state = async_epoll::fd_state {};
+    }
+
+    void async_epoll::ready_push(net::fd_t fd, fd_state& state) {
+        if (state.queued) return;
+        state.queued = true;
+        m_ready.push_back(fd);
+    }
+
     // Remove one direction from fd_state; update or DEL epoll registration.
     void async_epoll::fd_disarm(net::fd_t fd, fd_state& state, bool is_write) {
         if (is_write) {
@@ -49,185 +159,633 @@ namespace bee::async {
         } else {
             state.read_op = nullptr;
         }
+        fd_update(m_epfd, m_stats, fd, state);
+    }
+
+    async_epoll::fd_state& async_epoll::fd_get(net::fd_t fd) {
+        size_t idx = static_cast<size_t>(fd);
+        if (idx >= m_fd_states.size()) {
+            m_fd_states.resize(std::max(idx + 1, m_fd_states.size() * 2));
+        }
+        return m_fd_states[idx];
+    }
 
-        uint32_t new_events = 0;
-        if (state.read_op) new_events |= EPOLLIN;
-        if (state.write_op) new_events |= EPOLLOUT;
+    async_epoll::fd_state* async_epoll::fd_find(net::fd_t fd) {
+        size_t idx = static_cast<size_t>(fd);
+        if (fd < 0 || idx >= m_fd_states.size()) return nullptr;
+        auto& state = m_fd_states[idx];
+        if (!state.read_op && !state.write_op) return nullptr;
+        return &state;
+    }
 
-        if (new_events == 0) {
-            epoll_ctl(m_epfd, EPOLL_CTL_DEL, fd, nullptr);
-            state.events = 0;
-            m_fd_states.erase(fd);
-        } else if (new_events != state.events) {
-            struct epoll_event ev;
-            memset(&ev, 0, sizeof(ev));
-            ev.events  = new_events;
-            ev.data.fd = fd;
-            epoll_ctl(m_epfd, EPOLL_CTL_MOD, fd, &ev);
-            state.events = new_events;
+    static async_op to_async_op(async_epoll::pending_op::type_t type) noexcept {
+        switch (type) {
+        case async_epoll::pending_op::read:
+            return async_op::read;
+        case async_epoll::pending_op::write:
+            return async_op::write;
+        case async_epoll::pending_op::accept:
+            return async_op::accept;
+        case async_epoll::pending_op::connect:
+            return async_op::connect;
+        case async_epoll::pending_op::fd_poll:
+            return async_op::fd_poll;
+        case async_epoll::pending_op::recv:
+            return async_op::recv;
+        case async_epoll::pending_op::timer:
+            return async_op::timer;
+        case async_epoll::pending_op::sendfile:
+            return async_op::sendfile;
+        case async_epoll::pending_op::relay:
+            return async_op::relay;
+        case async_epoll::pending_op::recvfrom:
+            return async_op::recvfrom;
+        case async_epoll::pending_op::sendto:
+            return async_op::sendto;
+        default:
+            std::unreachable();
         }
     }
 
-    bool async_epoll::submit_read(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id) {
-        auto& state = m_fd_states[fd];
-        if (state.read_op) return false;
+    // Return op's slot to the slab.  Bumping gen invalidates any deadline
+    // still queued for it.
+    static void op_release(slab<async_epoll::pending_op>& ops, async_epoll::pending_op* op) {
+        op->gen++;
+        ops.free(op->slot);
+    }
 
-        auto* op       = new pending_op();
+    async_epoll::pending_op* async_epoll::op_new(net::fd_t fd, pending_op::type_t type, uint64_t request_id) {
+        uint32_t idx   = m_ops.alloc();
+        auto* op       = &m_ops[idx];
+        op->slot       = idx;
         op->request_id = request_id;
         op->fd         = fd;
-        op->type       = pending_op::read;
-        op->wv         = dynarray<net::socket::iobuf>(bufs.data(), bufs.size());
+        op->type       = type;
+        op->pool       = nullptr;
+        op->multishot  = false;
+        op->total      = 0;
+        op->submitted  = std::chrono::steady_clock::now();
+        op->wv.clear();
+        m_stats.submitted(to_async_op(type));
+        return op;
+    }
 
-        state.read_op = op;
-        if (!fd_arm(fd, state)) {
-            state.read_op = nullptr;
-            if (!state.write_op) m_fd_states.erase(fd);
-            delete op;
-            return false;
-        }
-        return true;
+    // Give back an op whose request was refused after op_new counted it.
+    void async_epoll::op_discard(pending_op* op) {
+        m_stats.submits[static_cast<size_t>(to_async_op(op->type))]--;
+        m_stats.submit_failures++;
+        op_release(m_ops, op);
     }
 
-    bool async_epoll::submit_write(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id) {
-        auto& state = m_fd_states[fd];
-        if (state.write_op) return false;  // 同一 fd 写方向最多一个 in-flight op
+    // Take a context from the slab and install it as the read or write op of
+    // fd.  When timeout >= 0 a deadline is queued as well.  Returns nullptr
+    // if that direction is busy or epoll_ctl fails.
 
-        auto* op       = new pending_op();
-        op->request_id = request_id;
-        op->fd         = fd;
-        op->type       = pending_op::write;
-        op->wv         = dynarray<net::socket::iobuf>(bufs.data(), bufs.size());
+    async_epoll::pending_op* async_epoll::op_arm(net::fd_t fd, bool is_write, pending_op::type_t type, uint64_t request_id, int timeout) {
+        if (fd < 0) {
+            m_stats.submit_failures++;
+            return nullptr;
+        }
+        auto& state = fd_get(fd);
+        auto& slot  = is_write ? state.write_op : state.read_op;
+        if (slot) {
+            m_stats.submit_failures++;
+            return nullptr;  // 同一 fd 同一方向最多一个 in-flight op
+        }
 
-        state.write_op = op;
-        if (!fd_arm(fd, state)) {
-            state.write_op = nullptr;
-            if (!state.read_op) m_fd_states.erase(fd);
-            delete op;
-            return false;
+        auto* op = op_new(fd, type, request_id);
+        slot     = op;
+        if (!fd_arm(fd, state, is_write)) {
+            slot = nullptr;
+            op_discard(op);
+            return nullptr;
+        }
+        if (timeout >= 0) {
+            m_deadlines.push({ std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout), op->slot, op->gen });
+        }
+        if (state.ready & fd_events(state)) {
+            ready_push(fd, state);
         }
+        return op;
+    }
+
+    void async_epoll::complete_now(uint64_t request_id, async_op op, async_status status, size_t bytes, int error_code) {
+        io_completion c;
+        c.request_id        = request_id;
+        c.op                = op;
+        c.status            = status;
+        c.bytes_transferred = bytes;
+        c.error_code        = error_code;
+        c.buffer_id         = -1;
+        c.more              = false;
+        m_sync_completions.push_back(c);
+        auto now = std::chrono::steady_clock::now();
+        m_stats.submitted(op);
+        m_stats.completed(op, now, now);
+        m_stats.sync_completions++;
+    }
+
+    // Reads and writes try their syscall at submit and only arm on EAGAIN:
+    // a write on a healthy connection, or a read with data already queued,
+    // completes without an epoll round trip.  Skipped when the direction
+    // is busy, or drained according to the edge-triggered readiness cache.
+    bool async_epoll::speculate(net::fd_t fd, bool is_write) {
+        if (fd < 0) return false;
+        auto& state = fd_get(fd);
+        if (is_write ? state.write_op : state.read_op) return false;
+        if ((state.events & EPOLLET) && !(state.ready & (is_write ? EPOLLOUT : EPOLLIN))) return false;
         return true;
     }
 
-    bool async_epoll::submit_accept(net::fd_t listen_fd, uint64_t request_id) {
-        auto& state = m_fd_states[listen_fd];
-        if (state.read_op) return false;  // 同一 fd 读方向最多一个 in-flight op
+    // The speculative syscall met EAGAIN: the cached readiness was stale.
+    void async_epoll::speculate_miss(net::fd_t fd, bool is_write) {
+        m_fd_states[fd].ready &= ~(is_write ? EPOLLOUT : EPOLLIN);
+    }
 
-        auto* op       = new pending_op();
-        op->request_id = request_id;
-        op->fd         = listen_fd;
-        op->type       = pending_op::accept;
+    bool async_epoll::submit_read(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id, int timeout) {
+        if (speculate(fd, false)) {
+            int rc = 0;
+            // readv leaves the iovec array itself untouched.
+            switch (net::socket::recvv(fd, rc, span<net::socket::iobuf>(const_cast<net::socket::iobuf*>(bufs.data()), bufs.size()))) {
+            case net::socket::recv_status::success:
+                complete_now(request_id, async_op::read, async_status::success, static_cast<size_t>(rc), 0);
+                return true;
+            case net::socket::recv_status::close:
+                complete_now(request_id, async_op::read, async_status::close, 0, 0);
+                return true;
+            case net::socket::recv_status::failed:
+                complete_now(request_id, async_op::read, async_status::error, 0, errno);
+                return true;
+            case net::socket::recv_status::wait:
+                speculate_miss(fd, false);
+                break;
+            }
+        }
+        auto* op = op_arm(fd, false, pending_op::read, request_id, timeout);
+        if (!op) return false;
+        op->wv.assign(bufs.begin(), bufs.end());
+        return true;
+    }
 
-        state.read_op = op;
-        if (!fd_arm(listen_fd, state)) {
-            state.read_op = nullptr;
-            if (!state.write_op) m_fd_states.erase(listen_fd);
-            delete op;
-            return false;
+    bool async_epoll::submit_write(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id, int timeout) {
+        if (speculate(fd, true)) {
+            int rc = 0;
+            switch (net::socket::sendv(fd, rc, bufs)) {
+            case net::socket::status::success:
+                complete_now(request_id, async_op::write, async_status::success, static_cast<size_t>(rc), 0);
+                return true;
+            case net::socket::status::failed:
+                complete_now(request_id, async_op::write, async_status::error, 0, errno);
+                return true;
+            case net::socket::status::wait:
+                speculate_miss(fd, true);
+                break;
+            }
         }
+        auto* op = op_arm(fd, true, pending_op::write, request_id, timeout);
+        if (!op) return false;
+        op->wv.assign(bufs.begin(), bufs.end());
+        return true;
+    }
+
+    bool async_epoll::submit_accept(net::fd_t listen_fd, uint64_t request_id, int timeout) {
+        return op_arm(listen_fd, false, pending_op::accept, request_id, timeout) != nullptr;
+    }
+
+    bool async_epoll::submit_accept_multishot(net::fd_t listen_fd, uint64_t request_id) {
+        auto* op = op_arm(listen_fd, false, pending_op::accept, request_id);
+        if (!op) return false;
+        op->multishot = true;
         return true;
     }
 
-    bool async_epoll::submit_connect(net::fd_t fd, const net::endpoint& ep, uint64_t request_id) {
+    bool async_epoll::submit_connect(net::fd_t fd, const net::endpoint& ep, uint64_t request_id, int timeout) {
+        if (m_edge) {
+            fd_renew(m_fd_states, fd);
+        }
         auto status = net::socket::connect(fd, ep);
         if (status == net::socket::status::success) {
-            io_completion c;
-            c.request_id        = request_id;
-            c.op                = async_op::connect;
-            c.status            = async_status::success;
-            c.bytes_transferred = 0;
-            c.error_code        = 0;
-            m_sync_completions.push_back(c);
+            complete_now(request_id, async_op::connect, async_status::success, 0, 0);
             return true;
         }
         if (status == net::socket::status::wait) {
-            auto& state = m_fd_states[fd];
-            if (state.write_op) return false;  // 同一 fd 写方向最多一个 in-flight op
-
-            auto* op       = new pending_op();
-            op->request_id = request_id;
-            op->fd         = fd;
-            op->type       = pending_op::connect;
-
-            state.write_op = op;
-            if (!fd_arm(fd, state)) {
-                state.write_op = nullptr;
-                if (!state.read_op) m_fd_states.erase(fd);
-                delete op;
-                return false;
-            }
-            return true;
+            return op_arm(fd, true, pending_op::connect, request_id, timeout) != nullptr;
         }
         return false;
     }
 
-    bool async_epoll::submit_file_read(file_handle::value_type fd, void* buffer, size_t len, int64_t offset, uint64_t request_id) {
+    // ---- file I/O worker pool ----
+    //
+    // epoll cannot wait for regular files, so blocking file syscalls run on
+    // up to max_threads worker threads.  Finished ops are queued in done and
+    // the eventfd (registered in the epoll set) wakes the loop, which moves
+    // them to m_sync_completions.
+
+    struct async_epoll::file_pool {
+        int efd              = -1;
+        uint32_t max_threads = 0;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<file_job> jobs;
+        std::vector<std::pair<io_completion, std::chrono::steady_clock::time_point>> done;  // with submit time
+        std::vector<thread_handle> threads;
+        size_t idle   = 0;  // workers blocked on cv
+        bool stopping = false;
+    };
+
+    // statx through syscall(2), since libc may not wrap it; before Linux
+    // 4.11 (or with headers that lack __NR_statx) the basic fields come
+    // from fstatat.
+    static int file_statx(int dirfd, const char* path, statx_result* st) noexcept {
+        int flags = path[0] == '\0' ? AT_EMPTY_PATH : 0;
+#if defined(__NR_statx)
+        int rc = static_cast<int>(::syscall(__NR_statx, dirfd, path, flags, statx_basic_stats, st));
+        if (rc == 0 || errno != ENOSYS) return rc;
+#endif
+        struct stat sb;
+        if (::fstatat(dirfd, path, &sb, flags) != 0) return -1;
+        memset(st, 0, sizeof(*st));
+        st->stx_mask          = statx_basic_stats;
+        st->stx_blksize       = static_cast<uint32_t>(sb.st_blksize);
+        st->stx_nlink         = static_cast<uint32_t>(sb.st_nlink);
+        st->stx_uid           = sb.st_uid;
+        st->stx_gid           = sb.st_gid;
+        st->stx_mode          = static_cast<uint16_t>(sb.st_mode);
+        st->stx_ino           = sb.st_ino;
+        st->stx_size          = static_cast<uint64_t>(sb.st_size);
+        st->stx_blocks        = static_cast<uint64_t>(sb.st_blocks);
+        st->stx_atime.tv_sec  = sb.st_atim.tv_sec;
+        st->stx_atime.tv_nsec = static_cast<uint32_t>(sb.st_atim.tv_nsec);
+        st->stx_mtime.tv_sec  = sb.st_mtim.tv_sec;
+        st->stx_mtime.tv_nsec = static_cast<uint32_t>(sb.st_mtim.tv_nsec);
+        st->stx_ctime.tv_sec  = sb.st_ctim.tv_sec;
+        st->stx_ctime.tv_nsec = static_cast<uint32_t>(sb.st_ctim.tv_nsec);
+        st->stx_rdev_major    = major(sb.st_rdev);
+        st->stx_rdev_minor    = minor(sb.st_rdev);
+        st->stx_dev_major     = major(sb.st_dev);
+        st->stx_dev_minor     = minor(sb.st_dev);
+        return 0;
+    }
+
+    // Run a file syscall; errno holds the error when it returns negative.
+    static io_completion run_file_job(const async_epoll::file_job& job) noexcept {
+        ssize_t res;
+        switch (job.op) {
+        case async_op::file_read:
+            res = pread(job.fd, job.buf, job.len, job.offset);
+            break;
+        case async_op::file_write:
+            res = pwrite(job.fd, job.data, job.len, job.offset);
+            break;
+        case async_op::file_open:
+            res = ::open(job.path, job.flags, job.mode);
+            break;
+        case async_op::file_close:
+            res = ::close(job.fd);
+            break;
+        case async_op::file_fsync:
+            res = job.flags ? ::fdatasync(job.fd) : ::fsync(job.fd);
+            break;
+        case async_op::file_statx:
+            res = file_statx(job.fd, job.path, static_cast<statx_result*>(job.buf));
+            break;
+        default:
+            std::unreachable();
+        }
         io_completion c;
-        c.request_id = request_id;
-        c.op         = async_op::file_read;
-        ssize_t n    = pread(fd, buffer, len, offset);
-        if (n >= 0) {
+        c.request_id = job.request_id;
+        c.op         = job.op;
+        c.buffer_id  = -1;
+        c.more       = false;
+        if (res >= 0) {
             c.status            = async_status::success;
-            c.bytes_transferred = static_cast<size_t>(n);
+            c.bytes_transferred = static_cast<size_t>(res);
             c.error_code        = 0;
         } else {
             c.status            = async_status::error;
             c.bytes_transferred = 0;
             c.error_code        = errno;
         }
-        m_sync_completions.push_back(c);
+        return c;
+    }
+
+    static void file_worker(void* ud) noexcept {
+        auto& pool = *static_cast<async_epoll::file_pool*>(ud);
+        std::unique_lock<std::mutex> lock(pool.mutex);
+        for (;;) {
+            while (pool.jobs.empty() && !pool.stopping) {
+                pool.idle++;
+                pool.cv.wait(lock);
+                pool.idle--;
+            }
+            if (pool.stopping) return;
+            async_epoll::file_job job = pool.jobs.front();
+            pool.jobs.pop_front();
+            lock.unlock();
+            io_completion c = run_file_job(job);
+            lock.lock();
+            // Only the first completion of a batch needs to wake the loop.
+            if (pool.done.empty()) {
+                uint64_t one = 1;
+                [[maybe_unused]] ssize_t n = write(pool.efd, &one, sizeof(one));
+            }
+            pool.done.emplace_back(c, job.submitted);
+        }
+    }
+
+    // Queue job on the worker pool, starting it on first use.  Without a
+    // pool (eventfd or thread creation failed) the job runs inline.
+    bool async_epoll::file_submit(const file_job& job) {
+        m_stats.submitted(job.op);
+        if (!m_file_pool) {
+            auto pool         = std::make_unique<file_pool>();
+            pool->max_threads = m_file_threads;
+            pool->efd         = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (pool->efd >= 0) {
+                struct epoll_event ev {};
+                ev.events  = EPOLLIN;
+                ev.data.fd = pool->efd;
+                m_stats.ctl_calls++;
+                if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, pool->efd, &ev) == 0) {
+                    m_file_pool = std::move(pool);
+                } else {
+                    close(pool->efd);
+                }
+            }
+        }
+        if (m_file_pool) {
+            auto& pool = *m_file_pool;
+            std::unique_lock<std::mutex> lock(pool.mutex);
+            pool.jobs.push_back(job);
+            pool.jobs.back().submitted = std::chrono::steady_clock::now();
+            if (pool.jobs.size() > pool.idle && pool.threads.size() < pool.max_threads) {
+                if (thread_handle h = thread_create(file_worker, &pool)) {
+                    pool.threads.push_back(h);
+                }
+            }
+            if (!pool.threads.empty()) {
+                lock.unlock();
+                pool.cv.notify_one();
+                m_file_inflight++;
+                return true;
+            }
+            pool.jobs.pop_back();
+        }
+        auto now = std::chrono::steady_clock::now();
+        m_sync_completions.push_back(run_file_job(job));
+        m_stats.completed(job.op, now, std::chrono::steady_clock::now());
+        m_stats.sync_completions++;
         return true;
     }
 
+    // Move finished file ops to m_sync_completions.
+    void async_epoll::file_collect() {
+        if (!m_file_pool) return;
+        auto& pool = *m_file_pool;
+        uint64_t n;
+        [[maybe_unused]] ssize_t r = read(pool.efd, &n, sizeof(n));
+        std::unique_lock<std::mutex> lock(pool.mutex);
+        auto now = std::chrono::steady_clock::now();
+        for (auto& [c, submitted] : pool.done) {
+            m_sync_completions.push_back(c);
+            m_stats.completed(c.op, submitted, now);
+        }
+        m_file_inflight -= pool.done.size();
+        pool.done.clear();
+    }
+
+    // Join the workers; queued jobs that have not started are dropped,
+    // except closes, which still run since the caller gave up its fd.  An
+    // open that finished but was never collected has its fd closed.
+    void async_epoll::file_pool_stop() {
+        if (!m_file_pool) return;
+        auto& pool = *m_file_pool;
+        std::deque<file_job> jobs;
+        {
+            std::unique_lock<std::mutex> lock(pool.mutex);
+            pool.stopping = true;
+            jobs.swap(pool.jobs);
+        }
+        pool.cv.notify_all();
+        for (auto h : pool.threads) {
+            thread_wait(h);
+        }
+        for (const auto& job : jobs) {
+            if (job.op == async_op::file_close) {
+                ::close(job.fd);
+            }
+        }
+        for (const auto& [c, submitted] : pool.done) {
+            if (c.op == async_op::file_open && c.status == async_status::success) {
+                ::close(static_cast<int>(c.bytes_transferred));
+            }
+        }
+        close(pool.efd);
+        m_file_pool.reset();
+    }
+
+    bool async_epoll::submit_file_read(file_handle::value_type fd, void* buffer, size_t len, int64_t offset, uint64_t request_id) {
+        file_job job {};
+        job.op         = async_op::file_read;
+        job.request_id = request_id;
+        job.fd         = fd;
+        job.buf        = buffer;
+        job.len        = len;
+        job.offset     = offset;
+        return file_submit(job);
+    }
+
     bool async_epoll::submit_file_write(file_handle::value_type fd, const void* buffer, size_t len, int64_t offset, uint64_t request_id) {
-        io_completion c;
-        c.request_id = request_id;
-        c.op         = async_op::file_write;
-        ssize_t n    = pwrite(fd, buffer, len, offset);
-        if (n >= 0) {
-            c.status            = async_status::success;
-            c.bytes_transferred = static_cast<size_t>(n);
-            c.error_code        = 0;
-        } else {
-            c.status            = async_status::error;
-            c.bytes_transferred = 0;
-            c.error_code        = errno;
+        file_job job {};
+        job.op         = async_op::file_write;
+        job.request_id = request_id;
+        job.fd         = fd;
+        job.data       = buffer;
+        job.len        = len;
+        job.offset     = offset;
+        return file_submit(job);
+    }
+
+    bool async_epoll::submit_file_open(const char* path, int flags, int mode, uint64_t request_id) {
+        file_job job {};
+        job.op         = async_op::file_open;
+        job.request_id = request_id;
+        job.path       = path;
+        job.flags      = flags;
+        job.mode       = mode;
+        return file_submit(job);
+    }
+
+    bool async_epoll::submit_file_close(file_handle::value_type fd, uint64_t request_id) {
+        file_job job {};
+        job.op         = async_op::file_close;
+        job.request_id = request_id;
+        job.fd         = fd;
+        return file_submit(job);
+    }
+
+    bool async_epoll::submit_fsync(file_handle::value_type fd, bool datasync, uint64_t request_id) {
+        file_job job {};
+        job.op         = async_op::file_fsync;
+        job.request_id = request_id;
+        job.fd         = fd;
+        job.flags      = datasync ? 1 : 0;
+        return file_submit(job);
+    }
+
+    bool async_epoll::submit_statx(file_handle::value_type dirfd, const char* path, void* statxbuf, uint64_t request_id) {
+        file_job job {};
+        job.op         = async_op::file_statx;
+        job.request_id = request_id;
+        job.fd         = dirfd;
+        job.path       = path;
+        job.buf        = statxbuf;
+        return file_submit(job);
+    }
+
+    bool async_epoll::submit_sendfile(net::fd_t fd, file_handle::value_type file, int64_t offset, uint64_t len, uint64_t request_id) {
+        if (len == 0) return false;
+        auto* op = op_arm(fd, true, pending_op::sendfile, request_id);
+        if (!op) return false;
+        op->src       = file;
+        op->offset    = offset;
+        op->remaining = len;
+        op->total     = 0;
+        return true;
+    }
+
+    // The relay takes the read side of src and the write side of dst and
+    // moves data through a pipe with splice(2): it waits on src while the
+    // pipe is empty and on dst while it holds data.
+    bool async_epoll::submit_relay(net::fd_t src, net::fd_t dst, uint64_t limit, uint64_t request_id) {
+        if (src < 0 || dst < 0) return false;
+        fd_get(std::max(src, dst));
+        auto& in  = m_fd_states[src];
+        auto& out = m_fd_states[dst];
+        if (in.read_op || out.write_op) return false;
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC | O_NONBLOCK) != 0) return false;
+
+        auto* op      = op_new(src, pending_op::relay, request_id);
+        op->dst       = dst;
+        op->pipe_r    = fds[0];
+        op->pipe_w    = fds[1];
+        op->piped     = 0;
+        op->remaining = limit ? limit : UINT64_MAX;
+        op->want_out  = false;
+        in.read_op    = op;
+        out.write_op  = op;
+        if (!fd_arm(src, in, false) || (m_edge && !fd_arm(dst, out, true))) {
+            in.read_op   = nullptr;
+            out.write_op = nullptr;
+            close(fds[0]);
+            close(fds[1]);
+            op_discard(op);
+            return false;
         }
-        m_sync_completions.push_back(c);
+        if (in.ready & EPOLLIN) {
+            ready_push(src, in);
+        }
+        return true;
+    }
+
+    bool async_epoll::submit_recvfrom(net::fd_t fd, void* buffer, size_t len, net::endpoint* ep, uint64_t request_id) {
+        auto* op = op_arm(fd, false, pending_op::recvfrom, request_id);
+        if (!op) return false;
+        op->wv.resize(1);
+        op->wv[0].set(static_cast<const char*>(buffer), len);
+        op->ep = ep;
+        return true;
+    }
+
+    bool async_epoll::submit_sendto(net::fd_t fd, const void* buffer, size_t len, const net::endpoint* ep, int gso, uint64_t request_id) {
+        auto* op = op_arm(fd, true, pending_op::sendto, request_id);
+        if (!op) return false;
+        op->wv.resize(1);
+        op->wv[0].set(static_cast<const char*>(buffer), len);
+        op->ep  = const_cast<net::endpoint*>(ep);
+        op->gso = gso;
         return true;
     }
 
     bool async_epoll::submit_poll(net::fd_t fd, uint64_t request_id) {
-        auto& state = m_fd_states[fd];
-        if (state.read_op) return false;  // 同一 fd 读方向最多一个 in-flight op
+        return op_arm(fd, false, pending_op::fd_poll, request_id) != nullptr;
+    }
 
-        auto* op       = new pending_op();
-        op->request_id = request_id;
-        op->fd         = fd;
-        op->type       = pending_op::fd_poll;
+    bool async_epoll::submit_recv(net::fd_t fd, uint16_t group, uint64_t request_id) {
+        if (group >= m_buffer_pools.size()) return false;
+        auto* op = op_arm(fd, false, pending_op::recv, request_id);
+        if (!op) return false;
+        op->pool = m_buffer_pools[group].get();
+        return true;
+    }
 
-        state.read_op = op;
-        if (!fd_arm(fd, state)) {
-            state.read_op = nullptr;
-            if (!state.write_op) m_fd_states.erase(fd);
-            delete op;
-            return false;
-        }
+    bool async_epoll::submit_recv_multishot(net::fd_t fd, uint16_t group, uint64_t request_id) {
+        if (!submit_recv(fd, group, request_id)) return false;
+        m_fd_states[fd].read_op->multishot = true;
+        return true;
+    }
+
+    // Timers share the deadline heap with per-op deadlines; wait() already
+    // sleeps no longer than the nearest one.
+    bool async_epoll::submit_timer(int timeout, uint64_t timer_id, uint64_t request_id) {
+        auto* op           = op_new(net::retired_fd, pending_op::timer, request_id);
+        op->timer_id       = timer_id;
+        m_timers[timer_id] = op->slot;
+        m_deadlines.push({ std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout), op->slot, op->gen });
         return true;
     }
 
+    int async_epoll::create_buffer_pool(size_t buf_size, uint16_t count) {
+        if (count == 0 || count > 32768 || buf_size == 0 || buf_size > UINT32_MAX) {
+            errno = EINVAL;
+            return -1;
+        }
+        size_t group = m_buffer_pools.size();
+        if (group > UINT16_MAX) {
+            errno = ENOSPC;
+            return -1;
+        }
+        if (!buffer_pool::fits(buf_size, count)) {
+            errno = ENOMEM;
+            return -1;
+        }
+        auto pool = std::make_unique<buffer_pool>(buf_size, count);
+        if (!pool->ok()) {
+            errno = ENOMEM;
+            return -1;
+        }
+        m_buffer_pools.emplace_back(std::move(pool));
+        return static_cast<int>(group);
+    }
+
+    buffer_pool* async_epoll::get_buffer_pool(uint16_t group) {
+        if (group >= m_buffer_pools.size()) return nullptr;
+        return m_buffer_pools[group].get();
+    }
+
+    bool async_epoll::recycle_buffer(uint16_t group, uint16_t bid) {
+        if (group >= m_buffer_pools.size()) return false;
+        auto& pool = *m_buffer_pools[group];
+        if (!pool.valid(bid)) return false;
+        return pool.release(bid);
+    }
+
     // Process one read-direction event. Returns true if a completion was produced.
     // If the syscall returns EAGAIN (spurious wakeup), returns false and leaves op intact.
     static bool process_read_op(
         int epfd,
+        async_stats& stats,
         net::fd_t fd,
         async_epoll::fd_state& state,
-        std::unordered_map<net::fd_t, async_epoll::fd_state>& fd_states,
+        slab<async_epoll::pending_op>& ops,
         io_completion& out
     ) {
         async_epoll::pending_op* op = state.read_op;
         out.request_id              = op->request_id;
         out.bytes_transferred       = 0;
         out.error_code              = 0;
+        out.more                    = false;
 
         bool produced = true;
 
@@ -254,6 +812,42 @@ namespace bee::async {
             }
             break;
         }
+        case async_epoll::pending_op::recv: {
+            // Emulates io_uring buffer selection: a pool buffer is taken only
+            // once the fd is readable, and handed back if nothing arrived.
+            out.op        = async_op::recv;
+            out.buffer_id = -1;
+            uint16_t bid  = 0;
+            if (!op->pool->acquire(bid)) {
+                out.status     = async_status::error;
+                out.error_code = ENOBUFS;
+                break;
+            }
+            int rc  = 0;
+            auto rs = net::socket::recv(fd, rc, op->pool->buffer(bid), static_cast<int>(op->pool->buf_size()));
+            switch (rs) {
+            case net::socket::recv_status::success:
+                out.status            = async_status::success;
+                out.bytes_transferred = static_cast<size_t>(rc);
+                out.buffer_id         = bid;
+                out.more              = op->multishot;
+                break;
+            case net::socket::recv_status::close:
+                out.status = async_status::close;
+                op->pool->release(bid);
+                break;
+            case net::socket::recv_status::failed:
+                out.status     = async_status::error;
+                out.error_code = errno;
+                op->pool->release(bid);
+                break;
+            case net::socket::recv_status::wait:
+                op->pool->release(bid);
+                produced = false;
+                break;
+            }
+            break;
+        }
         case async_epoll::pending_op::accept: {
             out.op          = async_op::accept;
             net::fd_t newfd = net::retired_fd;
@@ -262,6 +856,30 @@ namespace bee::async {
             case net::socket::status::success:
                 out.status            = async_status::success;
                 out.bytes_transferred = static_cast<size_t>(newfd);
+                out.more              = op->multishot;
+                break;
+            case net::socket::status::wait:
+                produced = false;
+                break;
+            case net::socket::status::failed:
+                out.status     = async_status::error;
+                out.error_code = errno;
+                break;
+            }
+            break;
+        }
+        case async_epoll::pending_op::recvfrom: {
+            // A one-entry recvmmsg also reports the GRO segment size.
+            out.op        = async_op::recvfrom;
+            out.buffer_id = -1;
+            auto& b       = op->wv[0];
+            net::socket::datagram msg { static_cast<char*>(b.iov_base), static_cast<int>(b.iov_len), op->ep };
+            int n = 0;
+            switch (net::socket::recvmmsg(fd, n, span<net::socket::datagram>(&msg, 1))) {
+            case net::socket::status::success:
+                out.status            = async_status::success;
+                out.bytes_transferred = static_cast<size_t>(msg.len);
+                if (msg.segsize > 0) out.buffer_id = msg.segsize;
                 break;
             case net::socket::status::wait:
                 produced = false;
@@ -287,38 +905,37 @@ namespace bee::async {
         }
 
         if (produced) {
+            // A multishot op times its next completion from this one.
+            auto now = std::chrono::steady_clock::now();
+            stats.completed(out.op, op->submitted, now);
+            op->submitted = now;
+        }
+        if (produced && !out.more) {
             // Completion ready: clear read slot and update epoll mask.
-            delete op;
-            state.read_op       = nullptr;
-            uint32_t new_events = state.write_op ? EPOLLOUT : 0;
-            if (new_events == 0) {
-                epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
-                state.events = 0;
-                fd_states.erase(fd);
-            } else if (new_events != state.events) {
-                struct epoll_event ev;
-                memset(&ev, 0, sizeof(ev));
-                ev.events  = new_events;
-                ev.data.fd = fd;
-                epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev);
-                state.events = new_events;
-            }
+            op_release(ops, op);
+            state.read_op = nullptr;
+            fd_update(epfd, stats, fd, state);
         }
         return produced;
     }
 
     // Process one write-direction event. Returns true if a completion was produced.
+    // sendfile(2) moves at most 0x7ffff000 bytes per call.
+    static constexpr uint64_t kSendfileChunk = 0x7ffff000;
+
     static bool process_write_op(
         int epfd,
+        async_stats& stats,
         net::fd_t fd,
         async_epoll::fd_state& state,
-        std::unordered_map<net::fd_t, async_epoll::fd_state>& fd_states,
+        slab<async_epoll::pending_op>& ops,
         io_completion& out
     ) {
         async_epoll::pending_op* op = state.write_op;
         out.request_id              = op->request_id;
         out.bytes_transferred       = 0;
         out.error_code              = 0;
+        out.more                    = false;
 
         bool produced = true;
 
@@ -342,6 +959,68 @@ namespace bee::async {
             }
             break;
         }
+        case async_epoll::pending_op::sendto: {
+            out.op  = async_op::sendto;
+            int rc  = 0;
+            auto& b = op->wv[0];
+            auto* p = static_cast<char*>(b.iov_base);
+            int len = static_cast<int>(b.iov_len);
+            net::socket::status ss;
+            if (op->gso > 0) {
+                // UDP_SEGMENT needs a control message: a one-entry sendmmsg.
+                net::socket::datagram msg { p, len, op->ep, op->gso };
+                int n = 0;
+                ss    = net::socket::sendmmsg(fd, n, span<const net::socket::datagram>(&msg, 1));
+                rc    = len;
+            } else {
+                ss = op->ep ? net::socket::sendto(fd, rc, p, len, *op->ep) : net::socket::send(fd, rc, p, len);
+            }
+            switch (ss) {
+            case net::socket::status::success:
+                out.status            = async_status::success;
+                out.bytes_transferred = static_cast<size_t>(rc);
+                break;
+            case net::socket::status::wait:
+                produced = false;
+                break;
+            case net::socket::status::failed:
+                out.status     = async_status::error;
+                out.error_code = errno;
+                break;
+            }
+            break;
+        }
+        case async_epoll::pending_op::sendfile: {
+            // Send until done or the socket is full; stays armed in between.
+            out.op   = async_op::sendfile;
+            produced = false;
+            while (op->remaining > 0) {
+                off_t off = op->offset;
+                ssize_t n = ::sendfile(fd, op->src, &off, std::min<uint64_t>(op->remaining, kSendfileChunk));
+                if (n > 0) {
+                    op->offset = off;
+                    op->remaining -= static_cast<uint64_t>(n);
+                    op->total += static_cast<uint64_t>(n);
+                } else if (n == 0) {
+                    op->remaining = 0;  // end of file
+                } else if (errno == EINTR) {
+                    continue;
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return false;
+                } else {
+                    out.status     = async_status::error;
+                    out.error_code = errno;
+                    produced       = true;
+                    break;
+                }
+            }
+            if (!produced) {
+                out.status            = async_status::success;
+                out.bytes_transferred = static_cast<size_t>(op->total);
+                produced              = true;
+            }
+            break;
+        }
         case async_epoll::pending_op::connect: {
             out.op  = async_op::connect;
             int err = 0;
@@ -359,34 +1038,115 @@ namespace bee::async {
         }
 
         if (produced) {
-            delete op;
-            state.write_op      = nullptr;
-            uint32_t new_events = state.read_op ? EPOLLIN : 0;
-            if (new_events == 0) {
-                epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
-                state.events = 0;
-                fd_states.erase(fd);
-            } else if (new_events != state.events) {
-                struct epoll_event ev;
-                memset(&ev, 0, sizeof(ev));
-                ev.events  = new_events;
-                ev.data.fd = fd;
-                epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev);
-                state.events = new_events;
-            }
+            stats.completed(out.op, op->submitted, std::chrono::steady_clock::now());
+            op_release(ops, op);
+            state.write_op = nullptr;
+            fd_update(epfd, stats, fd, state);
         }
         return produced;
     }
 
+    // Take a relay off both of its fds and close its pipe.
+    static void relay_detach(int epfd, async_stats& stats, std::vector<async_epoll::fd_state>& fd_states, async_epoll::pending_op* op) {
+        auto& in  = fd_states[op->fd];
+        auto& out = fd_states[op->dst];
+        in.read_op   = nullptr;
+        out.write_op = nullptr;
+        fd_update(epfd, stats, op->fd, in);
+        fd_update(epfd, stats, op->dst, out);
+        close(op->pipe_r);
+        close(op->pipe_w);
+    }
+
+    // Splices moved per wakeup before other fds get their turn.
+    static constexpr int kRelayRounds = 16;
+
+    // Move data fd -> pipe -> dst until one side would block, then wait on
+    // that side.  Returns true with out filled once the relay is over: EOF
+    // on fd, the byte limit reached, or an error on either side.  blocked
+    // tells a would-block stop from running out of rounds.
+    static bool relay_pump(
+        int epfd,
+        async_stats& stats,
+        std::vector<async_epoll::fd_state>& fd_states,
+        slab<async_epoll::pending_op>& ops,
+        async_epoll::pending_op* op,
+        io_completion& out,
+        bool& blocked
+    ) {
+        int err   = 0;
+        bool done = false;
+        blocked   = false;
+        for (int i = 0; i < kRelayRounds && !done; ++i) {
+            ssize_t n;
+            if (op->piped > 0) {
+                n = splice(op->pipe_r, nullptr, op->dst, nullptr, op->piped, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+                if (n > 0) {
+                    op->piped -= static_cast<uint32_t>(n);
+                    op->total += static_cast<uint64_t>(n);
+                    continue;
+                }
+            } else if (op->remaining == 0) {
+                done = true;
+                break;
+            } else {
+                size_t len = static_cast<size_t>(std::min<uint64_t>(op->remaining, 1u << 30));
+                n          = splice(op->fd, nullptr, op->pipe_w, nullptr, len, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+                if (n > 0) {
+                    op->piped += static_cast<uint32_t>(n);
+                    op->remaining -= static_cast<uint64_t>(n);
+                    continue;
+                }
+                if (n == 0) {
+                    done = true;  // end of stream
+                    break;
+                }
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                blocked = true;
+                break;
+            }
+            err  = n < 0 ? errno : EPIPE;
+            done = true;
+        }
+        if (!done) {
+            op->want_out = op->piped > 0;
+            if (fd_update(epfd, stats, op->fd, fd_states[op->fd]) && fd_update(epfd, stats, op->dst, fd_states[op->dst])) {
+                return false;
+            }
+            err = errno;
+        }
+        out.request_id        = op->request_id;
+        out.op                = async_op::relay;
+        out.status            = err ? async_status::error : async_status::success;
+        out.bytes_transferred = static_cast<size_t>(op->total);
+        out.error_code        = err;
+        out.buffer_id         = -1;
+        out.more              = false;
+        stats.completed(async_op::relay, op->submitted, std::chrono::steady_clock::now());
+        relay_detach(epfd, stats, fd_states, op);
+        op_release(ops, op);
+        return true;
+    }
+
+    // epoll_wait with a timeout in ns (-1 = infinite), see bpoll_wait_ns.
+    static int epoll_wait_ns(int epfd, async_stats& stats, struct epoll_event* events, int maxevents, int64_t timeout_ns) {
+        stats.wait_calls++;
+        return net::bpoll_wait_ns(epfd, span<net::bpoll_event_t>(events, static_cast<size_t>(maxevents)), timeout_ns);
+    }
+
     static int drain_epoll(
         int epfd,
+        async_stats& stats,
         const span<io_completion>& completions,
-        int timeout_ms,
-        std::unordered_map<net::fd_t, async_epoll::fd_state>& fd_states
+        int64_t timeout_ns,
+        std::vector<async_epoll::fd_state>& fd_states,
+        slab<async_epoll::pending_op>& ops
     ) {
         constexpr int kMaxEvents = 64;
         struct epoll_event events[kMaxEvents];
-        int nfds = epoll_wait(epfd, events, kMaxEvents, timeout_ms);
+        int nfds = epoll_wait_ns(epfd, stats, events, kMaxEvents, timeout_ns);
         if (nfds <= 0) {
             return 0;
         }
@@ -396,87 +1156,426 @@ namespace bee::async {
             uint32_t ev  = events[i].events;
             net::fd_t fd = static_cast<net::fd_t>(events[i].data.fd);
 
-            auto it = fd_states.find(fd);
-            if (it == fd_states.end()) continue;
-            auto& state = it->second;
+            if (fd < 0 || static_cast<size_t>(fd) >= fd_states.size()) continue;
+            auto& state = fd_states[fd];
 
             // Propagate errors to both directions.
             if (ev & (EPOLLERR | EPOLLHUP)) {
                 ev |= EPOLLIN | EPOLLOUT;
             }
 
-            // Process read direction.
+            // Process read direction.  A multishot op stays armed and is
+            // drained until it would block or the output span is full.
             if ((ev & EPOLLIN) && state.read_op) {
                 io_completion c;
-                if (process_read_op(epfd, fd, state, fd_states, c)) {
+                bool blocked;
+                if (state.read_op->type == async_epoll::pending_op::relay) {
+                    if (relay_pump(epfd, stats, fd_states, ops, state.read_op, c, blocked)) {
+                        completions[count++] = c;
+                    }
+                } else {
+                    while (process_read_op(epfd, stats, fd, state, ops, c)) {
+                        completions[count++] = c;
+                        if (!c.more || count >= static_cast<int>(completions.size())) break;
+                    }
+                }
+            }
+
+            // Process write direction.
+            if (count < static_cast<int>(completions.size()) && (ev & EPOLLOUT) && state.write_op) {
+                io_completion c;
+                bool blocked;
+                bool produced = state.write_op->type == async_epoll::pending_op::relay
+                                  ? relay_pump(epfd, stats, fd_states, ops, state.write_op, c, blocked)
+                                  : process_write_op(epfd, stats, fd, state, ops, c);
+                if (produced) {
                     completions[count++] = c;
                 }
             }
+        }
+        return count;
+    }
 
-            // Process write direction (re-lookup in case erase happened above).
-            if (count < static_cast<int>(completions.size()) && (ev & EPOLLOUT)) {
-                auto it2 = fd_states.find(fd);
-                if (it2 != fd_states.end() && it2->second.write_op) {
-                    io_completion c;
-                    if (process_write_op(epfd, fd, it2->second, fd_states, c)) {
-                        completions[count++] = c;
+    // The fixed file slot of an fd is the fd itself.
+    bool async_epoll::register_fd(int fd) {
+        return fd >= 0;
+    }
+
+    void async_epoll::unregister_fd(int fd) {
+        fd_forget(fd);
+    }
+
+    // ---- edge-triggered mode ----
+    //
+    // Each fd is registered with EPOLLIN|EPOLLOUT|EPOLLET and stays
+    // registered, so retiring ops and running them on cached readiness
+    // costs no epoll_ctl; only an op that starts waiting confirms the
+    // registration (fd_confirm).  An edge only says a direction
+    // became ready: it is cached in fd_state::ready until an op meets
+    // EAGAIN there, and an op armed on a ready direction runs on the next
+    // poll without waiting for another edge.  fds with work to do sit in
+    // m_ready, which also carries over whatever did not fit in one batch.
+
+    void async_epoll::drain_edge(int64_t timeout_ns) {
+        struct epoll_event events[kMaxEvents];
+        int nfds = epoll_wait_ns(m_epfd, m_stats, events, kMaxEvents, timeout_ns);
+        for (int i = 0; i < nfds; ++i) {
+            net::fd_t fd = static_cast<net::fd_t>(events[i].data.fd);
+            if (fd < 0 || static_cast<size_t>(fd) >= m_fd_states.size()) continue;
+            uint32_t ev = events[i].events;
+            if (ev & (EPOLLERR | EPOLLHUP)) {
+                ev |= EPOLLIN | EPOLLOUT;
+            }
+            auto& state = m_fd_states[fd];
+            state.ready |= ev & (EPOLLIN | EPOLLOUT);
+            if (state.ready & fd_events(state)) {
+                ready_push(fd, state);
+            }
+        }
+    }
+
+    int async_epoll::run_fd(net::fd_t fd, fd_state& state, const span<io_completion>& completions) {
+        int count = 0;
+        int cap   = static_cast<int>(completions.size());
+        // A relay stopped by a full side waits for that side's next edge;
+        // one stopped by its round limit comes back on the next poll.
+        auto relay = [&](pending_op* op) {
+            io_completion c;
+            bool blocked;
+            if (relay_pump(m_epfd, m_stats, m_fd_states, m_ops, op, c, blocked)) {
+                completions[count++] = c;
+                return;
+            }
+            net::fd_t side = op->want_out ? op->dst : op->fd;
+            uint32_t dir   = op->want_out ? EPOLLOUT : EPOLLIN;
+            auto& s        = m_fd_states[side];
+            if (blocked) {
+                s.ready &= ~dir;
+                fd_confirm(side, s);
+            } else {
+                s.ready |= dir;
+                ready_push(side, s);
+            }
+        };
+        if (state.ready & fd_events(state) & EPOLLIN) {
+            if (state.read_op->type == pending_op::relay) {
+                relay(state.read_op);
+            } else {
+                io_completion c;
+                bool produced;
+                while ((produced = process_read_op(m_epfd, m_stats, fd, state, m_ops, c))) {
+                    completions[count++] = c;
+                    if (c.op == async_op::accept && c.status == async_status::success) {
+                        fd_renew(m_fd_states, static_cast<net::fd_t>(c.bytes_transferred));
                     }
+                    if (!c.more || count >= cap) break;
+                }
+                if (!produced) {
+                    state.ready &= ~EPOLLIN;
+                    fd_confirm(fd, state);
+                }
+            }
+        }
+        if (count < cap && (state.ready & fd_events(state) & EPOLLOUT)) {
+            if (state.write_op->type == pending_op::relay) {
+                relay(state.write_op);
+            } else {
+                io_completion c;
+                if (process_write_op(m_epfd, m_stats, fd, state, m_ops, c)) {
+                    completions[count++] = c;
+                } else {
+                    state.ready &= ~EPOLLOUT;
+                    fd_confirm(fd, state);
                 }
             }
         }
+        if (state.ready & fd_events(state)) {
+            ready_push(fd, state);
+        }
         return count;
     }
 
-    int async_epoll::poll(const span<io_completion>& completions) {
+    // fds queued while running wait for the next round.
+    int async_epoll::run_ready(const span<io_completion>& completions) {
         int count = 0;
+        size_t n  = m_ready.size();
+        size_t i  = 0;
+        for (; i < n && count < static_cast<int>(completions.size()); ++i) {
+            net::fd_t fd = m_ready[i];
+            auto& state  = m_fd_states[fd];
+            if (!state.queued) continue;  // reset by cancel since it was queued
+            state.queued = false;
+            count += run_fd(fd, state, span<io_completion>(completions.data() + count, completions.size() - count));
+        }
+        m_ready.erase(m_ready.begin(), m_ready.begin() + i);
+        return count;
+    }
+
+    // ---- cross-thread post ----
+    //
+    // Posters push onto m_posts with a CAS and ring m_post_efd only when the
+    // stack was empty; the owner swaps the whole stack out and reverses it.
+    // The eventfd is edge-triggered and never read: every write is a new
+    // edge, and a ring for values that were already collected costs one
+    // spurious wakeup.
+
+    bool async_epoll::post(uint64_t request_id) {
+        if (m_post_efd < 0) {
+            errno = EBADF;
+            return false;
+        }
+        auto* node = new post_node { nullptr, request_id };
+        post_node* head = m_posts.load(std::memory_order_relaxed);
+        do {
+            node->next = head;
+        } while (!m_posts.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+        if (head == nullptr) {
+            uint64_t one               = 1;
+            [[maybe_unused]] ssize_t r = write(m_post_efd, &one, sizeof(one));
+        }
+        return true;
+    }
+
+    void async_epoll::post_collect() {
+        if (!m_posts.load(std::memory_order_relaxed)) return;
+        post_node* node = m_posts.exchange(nullptr, std::memory_order_acquire);
+        post_node* fifo = nullptr;
+        while (node) {
+            post_node* next = node->next;
+            node->next      = fifo;
+            fifo            = node;
+            node            = next;
+        }
+        while (fifo) {
+            post_node* next = fifo->next;
+            io_completion c;
+            c.request_id        = fifo->request_id;
+            c.op                = async_op::post;
+            c.status            = async_status::success;
+            c.bytes_transferred = 0;
+            c.error_code        = 0;
+            c.buffer_id         = -1;
+            c.more              = false;
+            m_sync_completions.push_back(c);
+            m_stats.completions[static_cast<size_t>(async_op::post)]++;
+            delete fifo;
+            fifo = next;
+        }
+    }
+
+    void async_epoll::stats(async_stats& out) {
+        out           = m_stats;
+        out.inflight  = m_ops.in_use() + m_file_inflight;
+        out.spin_ns   = m_busy.spin_ns;
+        out.block_ns  = m_busy.block_ns;
+        out.spin_hits = m_busy.spin_hits;
+    }
+
+    // Complete every op whose deadline has passed with async_status::timeout,
+    // and every expired timer with async_status::success.
+    void async_epoll::expire_deadlines() {
+        if (m_deadlines.empty()) return;
+        auto now = std::chrono::steady_clock::now();
+        while (!m_deadlines.empty() && m_deadlines.top().when <= now) {
+            deadline e = m_deadlines.top();
+            m_deadlines.pop();
+            pending_op* op = &m_ops[e.slot];
+            if (op->gen != e.gen) continue;  // already completed or cancelled
+            if (op->type == pending_op::timer) {
+                m_timers.erase(op->timer_id);
+                retire_op(op, async_status::success);
+                continue;
+            }
+            net::fd_t fd  = op->fd;
+            auto& state   = m_fd_states[fd];
+            bool is_write = state.write_op == op;
+            retire_op(op, async_status::timeout);
+            fd_disarm(fd, state, is_write);
+        }
+    }
+
+    // Shorten an epoll_wait timeout (ms, -1 = infinite) so the nearest
+    // deadline is not overslept.
+    int64_t async_epoll::deadline_timeout(int64_t timeout_ns) const {
+        if (m_deadlines.empty()) return timeout_ns;
+        int64_t left = std::chrono::duration_cast<std::chrono::nanoseconds>(m_deadlines.top().when - std::chrono::steady_clock::now()).count();
+        if (left < 0) left = 0;
+        if (timeout_ns < 0 || left < timeout_ns) return left;
+        return timeout_ns;
+    }
 
+    int async_epoll::take_sync(const span<io_completion>& completions) {
+        int count = 0;
         while (!m_sync_completions.empty() && count < static_cast<int>(completions.size())) {
             completions[count++] = m_sync_completions.front();
             m_sync_completions.pop_front();
         }
+        return count;
+    }
+
+    int async_epoll::poll(const span<io_completion>& completions) {
+        int count = take_sync(completions);
         if (count >= static_cast<int>(completions.size())) {
             return count;
         }
 
-        count += drain_epoll(m_epfd, span<io_completion>(completions.data() + count, completions.size() - count), 0, m_fd_states);
+        auto rest = span<io_completion>(completions.data() + count, completions.size() - count);
+        if (m_edge) {
+            drain_edge(0);
+            count += run_ready(rest);
+        } else {
+            count += drain_epoll(m_epfd, m_stats, rest, 0, m_fd_states, m_ops);
+        }
+        file_collect();
+        post_collect();
+        expire_deadlines();
+        count += take_sync(span<io_completion>(completions.data() + count, completions.size() - count));
         return count;
     }
 
     int async_epoll::wait(const span<io_completion>& completions, int timeout) {
-        int count = 0;
+        return wait_ns(completions, timeout < 0 ? -1 : static_cast<int64_t>(timeout) * 1000000);
+    }
 
-        while (!m_sync_completions.empty() && count < static_cast<int>(completions.size())) {
-            completions[count++] = m_sync_completions.front();
-            m_sync_completions.pop_front();
-        }
+    int async_epoll::wait_ns(const span<io_completion>& completions, int64_t timeout_ns) {
+        return m_busy.wait(
+            timeout_ns,
+            [&] { return poll(completions); },
+            [&](int64_t rest) { return wait_block(completions, rest); }
+        );
+    }
+
+    int async_epoll::wait_block(const span<io_completion>& completions, int64_t timeout_ns) {
+        int count = take_sync(completions);
         if (count > 0 || completions.size() == 0) {
             return count;
         }
 
-        count += drain_epoll(m_epfd, completions, timeout, m_fd_states);
-        return count;
+        // A deadline may cut epoll_wait short without producing anything
+        // (the op already finished); keep waiting out the caller's timeout.
+        auto start = std::chrono::steady_clock::now();
+        for (;;) {
+            int64_t remaining = timeout_ns;
+            if (timeout_ns > 0) {
+                int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+                remaining       = elapsed >= timeout_ns ? 0 : timeout_ns - elapsed;
+            }
+            if (m_edge) {
+                drain_edge(m_ready.empty() ? deadline_timeout(remaining) : 0);
+                count = run_ready(completions);
+            } else {
+                count = drain_epoll(m_epfd, m_stats, completions, deadline_timeout(remaining), m_fd_states, m_ops);
+            }
+            file_collect();
+            post_collect();
+            expire_deadlines();
+            count += take_sync(span<io_completion>(completions.data() + count, completions.size() - count));
+            if (count > 0 || remaining == 0) {
+                return count;
+            }
+        }
     }
 
     void async_epoll::stop() {
+        file_pool_stop();
+        for (auto& state : m_fd_states) {
+            if (state.read_op && state.read_op->type == pending_op::relay) {
+                close(state.read_op->pipe_r);
+                close(state.read_op->pipe_w);
+            }
+        }
+        if (m_post_efd >= 0) {
+            close(m_post_efd);
+            m_post_efd = -1;
+        }
+        for (post_node* node = m_posts.exchange(nullptr); node;) {
+            post_node* next = node->next;
+            delete node;
+            node = next;
+        }
         if (m_epfd >= 0) {
             close(m_epfd);
             m_epfd = -1;
         }
-        for (auto& [fd, state] : m_fd_states) {
-            delete state.read_op;
-            delete state.write_op;
-        }
         m_fd_states.clear();
+        m_ops       = {};
+        m_deadlines = {};
+        m_ready.clear();
+        m_timers.clear();
+        m_buffer_pools.clear();
+        m_stats         = {};
+        m_file_inflight = 0;
+        m_busy          = busy_poll(m_busy.max_ns);
+    }
+
+    // Retire op with a completion of the given status (cancel or timeout),
+    // matching the -ECANCELED completion io_uring delivers for
+    // IORING_OP_ASYNC_CANCEL and IORING_OP_LINK_TIMEOUT.
+    void async_epoll::retire_op(pending_op* op, async_status status) {
+        io_completion c;
+        c.request_id        = op->request_id;
+        c.op                = to_async_op(op->type);
+        c.status            = status;
+        c.bytes_transferred = static_cast<size_t>(op->total);
+        c.error_code        = 0;
+        c.buffer_id         = -1;
+        c.more              = false;
+        m_sync_completions.push_back(c);
+        m_stats.completed(c.op, op->submitted, std::chrono::steady_clock::now());
+        op_release(m_ops, op);
+    }
+
+    void async_epoll::relay_cancel(pending_op* op) {
+        relay_detach(m_epfd, m_stats, m_fd_states, op);
+        retire_op(op, async_status::cancel);
     }
 
     void async_epoll::cancel(net::fd_t fd) {
-        auto it = m_fd_states.find(fd);
-        if (it == m_fd_states.end()) return;
-        auto& state = it->second;
+        auto* state = fd_find(fd);
+        if (!state) {
+            fd_forget(fd);
+            return;
+        }
+        if (state->read_op && state->read_op->type == pending_op::relay) relay_cancel(state->read_op);
+        if (state->write_op && state->write_op->type == pending_op::relay) relay_cancel(state->write_op);
+        state = fd_find(fd);
+        if (!state) {
+            fd_forget(fd);
+            return;
+        }
+        m_stats.ctl_calls++;
         epoll_ctl(m_epfd, EPOLL_CTL_DEL, fd, nullptr);
-        delete state.read_op;
-        delete state.write_op;
-        m_fd_states.erase(it);
+        if (state->read_op) retire_op(state->read_op, async_status::cancel);
+        if (state->write_op) retire_op(state->write_op, async_status::cancel);
+        *state = fd_state {};
+    }
+
+    void async_epoll::cancel(net::fd_t fd, async_op op) {
+        auto* state = fd_find(fd);
+        if (!state) return;
+        if (op == async_op::relay) {
+            if (state->read_op && state->read_op->type == pending_op::relay) {
+                relay_cancel(state->read_op);
+            } else if (state->write_op && state->write_op->type == pending_op::relay) {
+                relay_cancel(state->write_op);
+            }
+            return;
+        }
+        if (state->read_op && to_async_op(state->read_op->type) == op) {
+            retire_op(state->read_op, async_status::cancel);
+            fd_disarm(fd, *state, false);
+        } else if (state->write_op && to_async_op(state->write_op->type) == op) {
+            retire_op(state->write_op, async_status::cancel);
+            fd_disarm(fd, *state, true);
+        }
+    }
+
+    void async_epoll::cancel_timer(uint64_t timer_id) {
+        auto it = m_timers.find(timer_id);
+        if (it == m_timers.end()) return;
+        pending_op* op = &m_ops[it->second];
+        m_timers.erase(it);
+        retire_op(op, async_status::cancel);
     }
 
 }  // namespace bee::async
@@ -4,13 +4,20 @@
 #include <bee/net/fd.h>
 #include <bee/net/socket.h>
 #include <bee/sys/file_handle.h>
-#include <bee/utility/dynarray.h>
+#include <bee/utility/busy_poll.h>
+#include <bee/utility/slab.h>
 #include <bee/utility/span.h>
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
+#include <functional>
+#include <memory>
+#include <queue>
 #include <unordered_map>
+#include <vector>
 
 namespace bee::net {
     struct endpoint;
@@ -20,22 +27,46 @@ namespace bee::async {
 
     class async_epoll : public async {
     public:
-        async_epoll();
+        explicit async_epoll(const async_options& options = {});
         ~async_epoll() override;
 
-        bool submit_read(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id) override;
-        bool submit_write(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id) override;
-        bool submit_accept(net::fd_t listen_fd, uint64_t request_id) override;
-        bool submit_connect(net::fd_t fd, const net::endpoint& ep, uint64_t request_id) override;
+        bool submit_read(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id, int timeout = -1) override;
+        bool submit_write(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id, int timeout = -1) override;
+        bool submit_accept(net::fd_t listen_fd, uint64_t request_id, int timeout = -1) override;
+        bool submit_accept_multishot(net::fd_t listen_fd, uint64_t request_id) override;
+        bool submit_connect(net::fd_t fd, const net::endpoint& ep, uint64_t request_id, int timeout = -1) override;
         bool submit_file_read(file_handle::value_type fd, void* buffer, size_t len, int64_t offset, uint64_t request_id) override;
         bool submit_file_write(file_handle::value_type fd, const void* buffer, size_t len, int64_t offset, uint64_t request_id) override;
+        bool submit_file_open(const char* path, int flags, int mode, uint64_t request_id) override;
+        bool submit_file_close(file_handle::value_type fd, uint64_t request_id) override;
+        bool submit_fsync(file_handle::value_type fd, bool datasync, uint64_t request_id) override;
+        bool submit_statx(file_handle::value_type dirfd, const char* path, void* statxbuf, uint64_t request_id) override;
+        bool submit_sendfile(net::fd_t fd, file_handle::value_type file, int64_t offset, uint64_t len, uint64_t request_id) override;
+        bool submit_relay(net::fd_t src, net::fd_t dst, uint64_t limit, uint64_t request_id) override;
+        bool submit_recvfrom(net::fd_t fd, void* buffer, size_t len, net::endpoint* ep, uint64_t request_id) override;
+        bool submit_sendto(net::fd_t fd, const void* buffer, size_t len, const net::endpoint* ep, int gso, uint64_t request_id) override;
         bool submit_poll(net::fd_t fd, uint64_t request_id) override;
+        bool submit_recv(net::fd_t fd, uint16_t group, uint64_t request_id) override;
+        bool submit_recv_multishot(net::fd_t fd, uint16_t group, uint64_t request_id) override;
+        bool submit_timer(int timeout, uint64_t timer_id, uint64_t request_id) override;
+        bool post(uint64_t request_id) override;
+        void stats(async_stats& out) override;
+        int create_buffer_pool(size_t buf_size, uint16_t count) override;
+        buffer_pool* get_buffer_pool(uint16_t group) override;
+        bool recycle_buffer(uint16_t group, uint16_t bid) override;
+        bool register_fd(int fd) override;
+        void unregister_fd(int fd) override;
         int poll(const span<io_completion>& completions) override;
         int wait(const span<io_completion>& completions, int timeout) override;
+        int wait_ns(const span<io_completion>& completions, int64_t timeout_ns) override;
         void stop() override;
         void cancel(net::fd_t fd) override;
+        void cancel(net::fd_t fd, async_op op) override;
+        void cancel_timer(uint64_t timer_id) override;
 
         struct pending_op {
+            uint32_t slot       = 0;  // index in m_ops
+            uint32_t gen        = 0;  // bumped on release; matches deadline::gen while armed
             uint64_t request_id = 0;
             net::fd_t fd        = net::retired_fd;
             enum type_t : uint8_t {
@@ -44,31 +75,163 @@ namespace bee::async {
                 accept,
                 connect,
                 fd_poll,
+                recv,
+                timer,     // no fd: lives only in m_deadlines and m_timers
+                sendfile,  // write direction of the socket
+                relay,     // read direction of fd (source) and write direction of dst
+                recvfrom,
+                sendto,
             } type = read;
-            dynarray<net::socket::iobuf> wv;  // used when type == write or read
+            std::vector<net::socket::iobuf> wv;    // used when type == write, read, recvfrom or sendto
+            buffer_pool* pool  = nullptr;          // used when type == recv
+            bool multishot     = false;            // stays armed after each completion
+            int src            = -1;               // sendfile: source file
+            int64_t offset     = 0;                // sendfile: next file offset
+            uint64_t remaining = 0;                // sendfile/relay: bytes still to send
+            uint64_t total     = 0;                // sendfile/relay: bytes sent so far
+            net::fd_t dst      = net::retired_fd;  // relay: destination socket
+            int pipe_r         = -1;               // relay: pipe between fd and dst
+            int pipe_w         = -1;
+            uint32_t piped     = 0;                // relay: bytes sitting in the pipe
+            bool want_out      = false;            // relay: waiting for dst rather than fd
+            uint64_t timer_id  = 0;                // timer: key in m_timers
+            net::endpoint* ep  = nullptr;          // recvfrom: sender; sendto: destination or nullptr
+            int gso            = 0;                // sendto: UDP GSO segment size
+            std::chrono::steady_clock::time_point submitted;  // start of the latency measured for stats
         };
 
         // Per-fd state: tracks up to one read-direction and one write-direction pending op,
-        // plus the currently registered epoll events mask.
+        // plus the currently registered epoll events mask.  A relay sits in
+        // both directions it uses but waits on one at a time (want_out).
+        //
+        // In edge-triggered mode the fd is registered for both directions
+        // (events has EPOLLET) and stays registered while idle;
+        // ready caches the directions reported by epoll that no op has yet
+        // drained to EAGAIN.
         struct fd_state {
             pending_op* read_op  = nullptr;  // EPOLLIN direction (read/accept/connect)
             pending_op* write_op = nullptr;  // EPOLLOUT direction (write)
             uint32_t events      = 0;        // currently registered events mask
+            uint32_t ready       = 0;        // edge-triggered: EPOLLIN/EPOLLOUT known ready
+            bool queued          = false;    // edge-triggered: listed in m_ready
+        };
+
+        // A blocking file syscall handed to the worker pool.
+        struct file_job {
+            async_op op;
+            uint64_t request_id;
+            int fd;            // file_statx: dirfd
+            void* buf;         // file_read: destination; file_statx: statx_result
+            const void* data;  // file_write: source
+            size_t len;
+            int64_t offset;
+            const char* path;  // file_open / file_statx
+            int flags;         // file_open: open flags; file_fsync: datasync
+            int mode;          // file_open
+            std::chrono::steady_clock::time_point submitted;
+        };
+
+        struct file_pool;
+
+        // A posted value on its way from another thread.
+        struct post_node {
+            post_node* next;
+            uint64_t request_id;
         };
 
     private:
         int m_epfd;
         std::deque<io_completion> m_sync_completions;
-        std::unordered_map<net::fd_t, fd_state> m_fd_states;
+        // Per-op deadline; stale entries (gen mismatch) are skipped lazily.
+        struct deadline {
+            std::chrono::steady_clock::time_point when;
+            uint32_t slot;
+            uint32_t gen;
+            bool operator>(const deadline& o) const noexcept { return when > o.when; }
+        };
+
+        std::vector<fd_state> m_fd_states;  // indexed by fd
+        slab<pending_op> m_ops;
+        std::priority_queue<deadline, std::vector<deadline>, std::greater<>> m_deadlines;
+        std::unordered_map<uint64_t, uint32_t> m_timers;  // submit_timer timer_id -> op slot
+        std::vector<std::unique_ptr<buffer_pool>> m_buffer_pools;  // indexed by group id
+        std::unique_ptr<file_pool> m_file_pool;                    // started by the first file op
+        uint32_t m_file_threads;
+        bool m_edge;                      // edge-triggered mode
+        std::vector<net::fd_t> m_ready;   // edge-triggered: fds with an op to run on cached readiness
+        int m_post_efd;                   // eventfd (EPOLLET) rung when m_posts becomes non-empty
+        std::atomic<post_node*> m_posts;  // lock-free stack of posted values, newest first
+        async_stats m_stats;
+        size_t m_file_inflight;           // jobs handed to the worker pool and not yet collected
+        busy_poll m_busy;                 // spin window in front of a blocking wait
 
-        static constexpr int kMaxEvents = 64;
+        static constexpr int kMaxEvents               = 64;
+        static constexpr uint32_t kDefaultFileThreads = 4;
+
+        // Grow-on-demand slot for fd in m_fd_states.
+        fd_state& fd_get(net::fd_t fd);
+
+        // Existing state with at least one pending op, or nullptr.
+        fd_state* fd_find(net::fd_t fd);
+
+        // Take an op from m_ops with its common fields reset.
+        pending_op* op_new(net::fd_t fd, pending_op::type_t type, uint64_t request_id);
+
+        // Release an op refused after op_new, undoing its submit count.
+        void op_discard(pending_op* op);
+
+        // Allocate an op for one direction of fd and register it with epoll.
+        pending_op* op_arm(net::fd_t fd, bool is_write, pending_op::type_t type, uint64_t request_id, int timeout = -1);
 
         // Register or update epoll for fd, merging read_op/write_op into a combined event mask.
         // Returns false on epoll_ctl failure.
-        bool fd_arm(net::fd_t fd, fd_state& state);
+        bool fd_arm(net::fd_t fd, fd_state& state, bool is_write);
+
+        // Edge-triggered: make sure fd is still in the epoll set before an op waits on it.
+        bool fd_confirm(net::fd_t fd, fd_state& state);
 
         // Remove one direction from fd_state; DEL if both directions gone.
         void fd_disarm(net::fd_t fd, fd_state& state, bool is_write);
+
+        // Edge-triggered: drop the registration of an idle fd.
+        void fd_forget(net::fd_t fd);
+
+        // Edge-triggered: list fd in m_ready once.
+        void ready_push(net::fd_t fd, fd_state& state);
+
+        // Edge-triggered: run the ops of queued fds on their cached readiness.
+        int run_ready(const span<io_completion>& completions);
+        int run_fd(net::fd_t fd, fd_state& state, const span<io_completion>& completions);
+
+        // Edge-triggered: epoll_wait, caching readiness and queueing fds.
+        void drain_edge(int64_t timeout_ns);
+
+        // Queue a completion with status for op and free it.
+        void retire_op(pending_op* op, async_status status);
+
+        // Queue a completion for a request that finished inside its submit call.
+        void complete_now(uint64_t request_id, async_op op, async_status status, size_t bytes, int error_code);
+
+        // Whether submit_read/submit_write should try the syscall before arming.
+        bool speculate(net::fd_t fd, bool is_write);
+        void speculate_miss(net::fd_t fd, bool is_write);
+
+        // Detach a relay from both of its fds and retire it as cancelled.
+        void relay_cancel(pending_op* op);
+
+        bool file_submit(const file_job& job);
+        void file_collect();
+        void file_pool_stop();
+
+        // Move posted values to m_sync_completions in posting order.
+        void post_collect();
+
+        void expire_deadlines();
+        int64_t deadline_timeout(int64_t timeout_ns) const;
+        int take_sync(const span<io_completion>& completions);
+
+        // wait_ns without the busy-poll window.
+        int wait_block(const span<io_completion>& completions, int64_t timeout_ns);
     };
 
 }  // namespace bee::async
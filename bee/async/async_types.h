@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 
@@ -10,6 +11,7 @@ namespace bee::async {
         close,
         error,
         cancel,
+        timeout,  // per-op deadline expired before the op completed
     };
 
     enum class async_op : uint8_t {
@@ -20,7 +22,23 @@ namespace bee::async {
         file_read,
         file_write,
         fd_poll,
-        timeout,  // internal: IORING_OP_TIMEOUT fallback, never surfaced to caller
+        recv,          // buffer-select receive: the backend picks a buffer_pool buffer on arrival
+        timer,         // submit_timer expiry (success) or cancel_timer (cancel)
+        file_open,     // bytes_transferred is the new fd
+        file_close,
+        file_fsync,
+        file_statx,
+        sendfile,      // bytes_transferred is the total sent; may be short at end of file
+        relay,         // socket -> socket until EOF or a byte limit; bytes_transferred is the total
+        recvfrom,      // one datagram; the sender is written to the endpoint given at submit
+        sendto,        // one datagram
+        post,          // async::post from any thread; request_id is the posted value
+        timeout,       // internal: IORING_OP_TIMEOUT fallback, never surfaced to caller
+        cancel,        // internal: IORING_OP_ASYNC_CANCEL, never surfaced to caller
+        link_timeout,  // internal: IORING_OP_LINK_TIMEOUT deadline, never surfaced to caller
+        splice_in,     // internal: file/socket -> pipe half of a splice pair, never surfaced to caller
+        splice_poll,   // internal: POLL_ADD gating a socket splice, never surfaced to caller
+        post_wake,     // internal: POLL_ADD on the post eventfd (no MSG_RING), never surfaced to caller
     };
 
     struct io_completion {
@@ -29,6 +47,64 @@ namespace bee::async {
         async_op op;
         size_t bytes_transferred;
         int error_code;
+        int32_t buffer_id;  // recv: buffer_pool bid holding the data; recvfrom: GRO segment size; -1 if none
+        bool more;          // multishot ops: further completions will follow for this request
+    };
+
+    // Counters reported by async::stats(), cumulative since create().  Each
+    // backend fills what it has and leaves the rest at zero.  latency[op]
+    // is a log2 histogram of submit-to-completion time: bucket 0 counts
+    // completions under 1us, bucket i those in [2^(i-1), 2^i) us, and the
+    // last bucket everything slower.  A multishot op is timed from the
+    // previous completion of the same request; a posted value only counts
+    // as a completion.
+    struct async_stats {
+        static constexpr size_t kOps            = static_cast<size_t>(async_op::post) + 1;
+        static constexpr size_t kLatencyBuckets = 32;
+
+        uint64_t submits[kOps]     = {};  // requests accepted per op
+        uint64_t completions[kOps] = {};  // completions surfaced per op
+        uint64_t submit_failures   = 0;   // submits rejected (io_uring: includes a full SQ)
+        uint64_t inflight          = 0;   // requests accepted and not yet finished
+        uint64_t sync_completions  = 0;   // epoll: finished inside the submit call
+        uint64_t enter_calls       = 0;   // io_uring: io_uring_enter
+        uint64_t cq_overflows      = 0;   // io_uring: flushes of the CQ overflow list
+        uint64_t wait_calls        = 0;   // epoll: epoll_wait
+        uint64_t ctl_calls         = 0;   // epoll: epoll_ctl
+        uint64_t spin_ns           = 0;   // busy_poll: time wait spent spinning
+        uint64_t block_ns          = 0;   // busy_poll: time wait spent blocked after spinning
+        uint64_t spin_hits         = 0;   // busy_poll: waits satisfied while spinning
+        uint64_t latency[kOps][kLatencyBuckets] = {};
+
+        void submitted(async_op op) noexcept {
+            submits[static_cast<size_t>(op)]++;
+        }
+
+        void completed(async_op op, std::chrono::steady_clock::time_point since, std::chrono::steady_clock::time_point now) noexcept {
+            auto us  = std::chrono::duration_cast<std::chrono::microseconds>(now - since).count();
+            size_t i = static_cast<size_t>(op);
+            size_t b = 0;
+            for (; us > 0; us >>= 1) b++;
+            completions[i]++;
+            latency[i][b < kLatencyBuckets ? b : kLatencyBuckets - 1]++;
+        }
+    };
+
+    // Backend tuning passed to create().  Every field is a hint: backends
+    // ignore what they do not support, and zero means "backend default".
+    struct async_options {
+        uint32_t entries          = 0;      // io_uring: SQ size
+        uint32_t cq_entries       = 0;      // io_uring: CQ size (IORING_SETUP_CQSIZE)
+        bool sqpoll               = false;  // io_uring: kernel thread polls the SQ
+        uint32_t sqpoll_idle      = 0;      // io_uring: SQPOLL thread idle time in ms
+        bool coop_taskrun         = false;  // io_uring: IORING_SETUP_COOP_TASKRUN
+        bool defer_taskrun        = false;  // io_uring: IORING_SETUP_DEFER_TASKRUN (implies single_issuer)
+        bool single_issuer        = false;  // io_uring: IORING_SETUP_SINGLE_ISSUER
+        uint32_t files            = 0;      // io_uring: registered file table size
+        size_t zerocopy_threshold = 0;      // io_uring: writes of at least this many bytes use SENDMSG_ZC (0 = never)
+        uint32_t file_threads     = 0;      // epoll: worker threads for file I/O
+        bool edge_triggered       = false;  // epoll: register each fd once with EPOLLET and cache readiness
+        uint32_t busy_poll        = 0;      // wait: spin up to this many us before blocking (adaptive, 0 = off)
     };
 
 }  // namespace bee::async
@@ -2,18 +2,31 @@
 #include <bee/async/async_uring_linux.h>
 #include <bee/net/endpoint.h>
 #include <bee/net/socket.h>
-#include <bee/utility/dynarray.h>
+#include <bee/utility/slab.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
 #include <sys/mman.h>
+#include <sys/resource.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 #include <poll.h>
 
+#include <sys/eventfd.h>
+
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cerrno>
+#include <chrono>
 #include <cstring>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 // ---- io_uring ABI definitions (no dependency on liburing or <linux/io_uring.h>) ----
 //
@@ -27,10 +40,26 @@
 #ifndef __NR_io_uring_enter
 #    define __NR_io_uring_enter 426
 #endif
+#ifndef __NR_io_uring_register
+#    define __NR_io_uring_register 427
+#endif
+#ifndef UDP_SEGMENT
+#    define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#    define UDP_GRO 104
+#endif
 
 // io_uring_setup flags
 enum {
-    BEE__IORING_SETUP_NO_SQARRAY = 0x10000u,  // kernel 6.6+: sq_array is implicit
+    BEE__IORING_SETUP_SQPOLL        = 1u << 1,   // kernel thread polls the SQ
+    BEE__IORING_SETUP_CQSIZE        = 1u << 3,   // params.cq_entries is valid
+    BEE__IORING_SETUP_CLAMP         = 1u << 4,   // clamp entries to the kernel maximum
+    BEE__IORING_SETUP_COOP_TASKRUN  = 1u << 8,   // kernel 5.19+: no IPI for task work
+    BEE__IORING_SETUP_TASKRUN_FLAG  = 1u << 9,   // kernel 5.19+: report pending task work in sqflags
+    BEE__IORING_SETUP_SINGLE_ISSUER = 1u << 12,  // kernel 6.0+: only one task submits
+    BEE__IORING_SETUP_DEFER_TASKRUN = 1u << 13,  // kernel 6.1+: run task work only in io_uring_enter
+    BEE__IORING_SETUP_NO_SQARRAY    = 0x10000u,  // kernel 6.6+: sq_array is implicit
 };
 
 // io_uring feature flags (returned in io_uring_params.features)
@@ -42,26 +71,75 @@ enum {
 // io_uring_enter flags
 enum {
     BEE__IORING_ENTER_GETEVENTS = 1u,
+    BEE__IORING_ENTER_SQ_WAKEUP = 2u,  // wake an idle SQPOLL thread
+    BEE__IORING_ENTER_SQ_WAIT   = 4u,  // kernel 5.10+: wait for SQ space (SQPOLL)
     BEE__IORING_ENTER_EXT_ARG   = 8u,  // arg is io_uring_getevents_arg (kernel 5.11+)
 };
 
+// io_uring_register opcodes
+enum {
+    BEE__IORING_REGISTER_FILES        = 2,
+    BEE__IORING_REGISTER_FILES_UPDATE = 6,   // kernel 5.5+
+    BEE__IORING_REGISTER_PROBE        = 8,   // kernel 5.6+
+    BEE__IORING_REGISTER_PBUF_RING    = 22,  // kernel 5.19+
+    BEE__IORING_UNREGISTER_PBUF_RING  = 23,
+};
+
+// sqe->flags
+enum {
+    BEE__IOSQE_FIXED_FILE    = 1u << 0,  // sqe->fd is an index into the registered file table
+    BEE__IOSQE_IO_LINK       = 1u << 2,  // next SQE starts only after this one completes
+    BEE__IOSQE_BUFFER_SELECT = 1u << 5,
+};
+
+// sqe->ioprio flags for IORING_OP_ACCEPT / IORING_OP_RECV
+enum {
+    BEE__IORING_ACCEPT_MULTISHOT = 1u << 0,  // kernel 5.19+
+    BEE__IORING_RECV_MULTISHOT   = 1u << 1,  // kernel 6.0+, requires IOSQE_BUFFER_SELECT
+};
+
+// cqe->flags
+enum {
+    BEE__IORING_CQE_F_BUFFER     = 1u << 0,  // upper 16 bits hold the selected buffer id
+    BEE__IORING_CQE_F_MORE       = 1u << 1,  // multishot request stays armed
+    BEE__IORING_CQE_F_NOTIF      = 1u << 3,  // zero-copy send: buffers released
+    BEE__IORING_CQE_BUFFER_SHIFT = 16,
+};
+
 // sq_ring flags (iou->sqflags)
 enum {
+    BEE__IORING_SQ_NEED_WAKEUP = 1u,  // SQPOLL thread went idle
     BEE__IORING_SQ_CQ_OVERFLOW = 2u,
+    BEE__IORING_SQ_TASKRUN     = 4u,  // TASKRUN_FLAG: task work pending, enter with GETEVENTS
 };
 
 // Opcodes we use
 enum {
-    BEE__IORING_OP_ACCEPT   = 13,
-    BEE__IORING_OP_CONNECT  = 16,
-    BEE__IORING_OP_READ     = 22,
-    BEE__IORING_OP_WRITE    = 23,
-    BEE__IORING_OP_SEND     = 26,
-    BEE__IORING_OP_RECV     = 27,
-    BEE__IORING_OP_SENDMSG  = 9,
-    BEE__IORING_OP_RECVMSG  = 10,
-    BEE__IORING_OP_POLL_ADD = 6,
-    BEE__IORING_OP_TIMEOUT  = 11,  // kernel 5.4+
+    BEE__IORING_OP_ACCEPT         = 13,
+    BEE__IORING_OP_CONNECT        = 16,
+    BEE__IORING_OP_READ           = 22,
+    BEE__IORING_OP_WRITE          = 23,
+    BEE__IORING_OP_SEND           = 26,
+    BEE__IORING_OP_RECV           = 27,
+    BEE__IORING_OP_SPLICE         = 30,  // kernel 5.7+
+    BEE__IORING_OP_FSYNC          = 3,
+    BEE__IORING_OP_SENDMSG        = 9,
+    BEE__IORING_OP_RECVMSG        = 10,
+    BEE__IORING_OP_POLL_ADD       = 6,
+    BEE__IORING_OP_TIMEOUT        = 11,  // kernel 5.4+
+    BEE__IORING_OP_TIMEOUT_REMOVE = 12,  // kernel 5.5+
+    BEE__IORING_OP_ASYNC_CANCEL   = 14,
+    BEE__IORING_OP_LINK_TIMEOUT   = 15,  // kernel 5.5+
+    BEE__IORING_OP_OPENAT         = 18,  // kernel 5.6+
+    BEE__IORING_OP_CLOSE          = 19,  // kernel 5.6+
+    BEE__IORING_OP_STATX          = 21,  // kernel 5.6+
+    BEE__IORING_OP_MSG_RING       = 40,  // kernel 5.18+
+    BEE__IORING_OP_SENDMSG_ZC     = 48,  // kernel 6.1+
+};
+
+// sqe->fsync_flags
+enum {
+    BEE__IORING_FSYNC_DATASYNC = 1u << 0,
 };
 
 struct bee__io_sqring_offsets {
@@ -100,6 +178,7 @@ struct bee__io_uring_sqe {
     };
     union {
         uint64_t addr;
+        uint64_t splice_off_in;
     };
     uint32_t len;
     union {
@@ -109,12 +188,17 @@ struct bee__io_uring_sqe {
         uint32_t statx_flags;
         uint32_t accept_flags;  // used by IORING_OP_ACCEPT
         uint32_t msg_flags;     // used by IORING_OP_SEND / RECV
+        uint32_t cancel_flags;  // used by IORING_OP_ASYNC_CANCEL
+        uint32_t splice_flags;  // used by IORING_OP_SPLICE
     };
     uint64_t user_data;
     union {
         uint16_t buf_index;
-        uint64_t pad[3];
+        uint16_t buf_group;  // used with IOSQE_BUFFER_SELECT
     };
+    uint16_t personality;
+    int32_t splice_fd_in;  // used by IORING_OP_SPLICE
+    uint64_t pad[2];
 };
 static_assert(64 == sizeof(bee__io_uring_sqe), "sqe size");
 static_assert(0 == __builtin_offsetof(bee__io_uring_sqe, opcode), "sqe.opcode");
@@ -125,6 +209,7 @@ static_assert(24 == __builtin_offsetof(bee__io_uring_sqe, len), "sqe.len");
 static_assert(28 == __builtin_offsetof(bee__io_uring_sqe, rw_flags), "sqe.rw_flags");
 static_assert(32 == __builtin_offsetof(bee__io_uring_sqe, user_data), "sqe.user_data");
 static_assert(40 == __builtin_offsetof(bee__io_uring_sqe, buf_index), "sqe.buf_index");
+static_assert(44 == __builtin_offsetof(bee__io_uring_sqe, splice_fd_in), "sqe.splice_fd_in");
 
 struct bee__io_uring_cqe {
     uint64_t user_data;
@@ -156,6 +241,52 @@ struct bee__io_uring_getevents_arg {
     uint64_t ts;  // pointer to __kernel_timespec
 };
 
+// One entry of a provided-buffer ring.  The ring tail lives in the resv field
+// of entry 0, so entries must be filled field by field (never assigned whole).
+struct bee__io_uring_buf {
+    uint64_t addr;
+    uint32_t len;
+    uint16_t bid;
+    uint16_t resv;
+};
+static_assert(16 == sizeof(bee__io_uring_buf), "io_uring_buf size");
+
+struct bee__io_uring_buf_reg {
+    uint64_t ring_addr;
+    uint32_t ring_entries;
+    uint16_t bgid;
+    uint16_t flags;
+    uint64_t resv[3];
+};
+static_assert(40 == sizeof(bee__io_uring_buf_reg), "io_uring_buf_reg size");
+
+struct bee__io_uring_files_update {
+    uint32_t offset;
+    uint32_t resv;
+    uint64_t fds;  // pointer to int32_t[nr_args]
+};
+static_assert(16 == sizeof(bee__io_uring_files_update), "io_uring_files_update size");
+
+struct bee__io_uring_probe_op {
+    uint8_t op;
+    uint8_t resv;
+    uint16_t flags;  // BEE__IO_URING_OP_SUPPORTED
+    uint32_t resv2;
+};
+
+enum {
+    BEE__IO_URING_OP_SUPPORTED = 1u << 0,
+};
+
+// Header of the IORING_REGISTER_PROBE result, followed by ops_len entries.
+struct bee__io_uring_probe {
+    uint8_t last_op;
+    uint8_t ops_len;
+    uint16_t resv;
+    uint32_t resv2[3];
+};
+static_assert(16 == sizeof(bee__io_uring_probe), "io_uring_probe size");
+
 struct bee__kernel_timespec {
     int64_t tv_sec;
     int64_t tv_nsec;
@@ -174,19 +305,79 @@ static inline int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_co
     return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size));
 }
 
+static inline int sys_io_uring_register(int fd, unsigned opcode, const void* arg, unsigned nr_args) noexcept {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
 // ---- io_uring ring state (kept behind the forward-declared pointer in the header) ----
 
-// Context kept alive on the heap for the duration of a SENDMSG operation.
-// msghdr.msg_iov points into bufs[], so both must outlive the CQE.
-struct iov_ctx {
-    struct msghdr msg = {};
-    bee::dynarray<bee::net::socket::iobuf> bufs;
-    explicit iov_ctx(bee::span<const bee::net::socket::iobuf> src)
-        : bufs(src.size()) {
-        for (size_t i = 0; i < src.size(); ++i) bufs[i] = src[i];
-        msg.msg_iov    = reinterpret_cast<struct iovec*>(bufs.data());
-        msg.msg_iovlen = static_cast<int>(src.size());
-    }
+// Per-operation context: one slab slot per in-flight request, addressed by the
+// slot index carried in the SQE user_data.  For RECVMSG/SENDMSG msghdr.msg_iov
+// points into bufs, so both must outlive the CQE; slots are never moved and
+// bufs keeps its capacity across reuse, so steady-state submits don't allocate.
+struct uring_op {
+    uint64_t request_id = 0;
+    bee::async::async_op op {};  // kind of request, also the op half of its user_data
+    struct msghdr msg   = {};
+    std::vector<bee::net::socket::iobuf> bufs;
+    int fd                 = -1;       // target socket or file (-1: none), for cancel and the zc copy fallback
+    uint32_t fd_pos        = 0;        // index of this slot in io_uring::fd_ops[fd]
+    bool live              = false;    // between uring_op_alloc and the release of the slot
+    bool zc                = false;    // write: sent with SENDMSG_ZC, completes on the notification CQE
+    int32_t res            = 0;        // zc/linked: result of the op CQE, held until the last CQE
+    bee::net::endpoint* ep = nullptr;  // recvfrom: takes msg.msg_namelen on completion
+    uint16_t group         = 0;        // recv: buffer group the kernel selects from
+
+    // Control message: receives the UDP_GRO segment size (recvfrom) or
+    // carries UDP_SEGMENT (sendto with gso).
+    alignas(struct cmsghdr) char cmsg[CMSG_SPACE(sizeof(int))];
+
+    // Deadline (IORING_OP_LINK_TIMEOUT linked after the op).  The op is
+    // surfaced once both its own CQE and the timeout's CQE have arrived.
+    // ts and timer_id also hold the expiry and key of a submit_timer.
+    bool linked    = false;
+    bool op_done   = false;
+    bool lt_done   = false;
+    bool timed_out = false;
+    bee__kernel_timespec ts {};
+    uint64_t timer_id = 0;
+
+    // Submit time, or the previous completion of a multishot request.
+    std::chrono::steady_clock::time_point submitted;
+
+    // Splice transfer (sendfile, relay): src -> pipe -> dst in chunks of
+    // at most the pipe size, surfaced as one completion of op when done.
+    // With a file source each chunk is a linked pair (splice_in, then op);
+    // a short splice_in breaks the link and only the bytes already in the
+    // pipe are sent on.  A socket source is read by a lone splice_in.
+    struct splice_state {
+        int src            = -1;
+        int dst            = -1;
+        int64_t src_off    = -1;  // -1 for a socket source
+        uint64_t remaining = 0;   // bytes still to read from src
+        uint64_t total     = 0;   // bytes written to dst
+        uint32_t chunk     = 0;   // length of the in-flight splice_in
+        uint32_t piped     = 0;   // bytes sitting in the pipe
+        int32_t in_res     = 0;   // result of the last splice_in
+        int32_t poll_res   = 0;   // error of the last splice_poll
+        bool paired        = false;
+        bool canceled      = false;
+        int pipe_r         = -1;
+        int pipe_w         = -1;
+        uint32_t pipe_size = 0;
+    } sp;
+};
+
+// Provided-buffer ring registered under buffer group id == index in io_uring::buf_rings.
+// The kernel consumes entries from head; we publish recycled buffers at tail.
+struct pbuf_ring {
+    bee::async::buffer_pool pool;
+    bee__io_uring_buf* bufs = nullptr;  // page-aligned ring shared with the kernel
+    size_t ringlen          = 0;
+    uint16_t mask           = 0;
+    uint16_t tail           = 0;
+    pbuf_ring(size_t buf_size, uint16_t count)
+        : pool(buf_size, count) {}
 };
 
 struct io_uring {
@@ -208,34 +399,93 @@ struct io_uring {
     uint32_t cqmask        = 0;
     bee__io_uring_cqe* cqes = nullptr;
 
+    // Setup flags actually granted by the kernel.
+    uint32_t setup_flags = 0;
+
+    // Writes of at least this many bytes use SENDMSG_ZC (0 = never).
+    size_t zc_threshold = 0;
+
     // Runtime capability flag: IORING_ENTER_EXT_ARG is supported (kernel 5.11+).
     // Probed on first use; false means we fall back to IORING_OP_TIMEOUT SQE.
     bool ext_arg_supported = true;
 
-    // Pending I/O contexts (msghdr + iobuf array) keyed by request_id, freed when CQE arrives.
-    std::unordered_map<uint64_t, std::unique_ptr<iov_ctx>> io_pending;
+    // In-flight operation contexts, released when the final CQE arrives.
+    bee::slab<uring_op> ops;
+
+    // Provided-buffer rings, indexed by buffer group id.
+    std::vector<std::unique_ptr<pbuf_ring>> buf_rings;
+
+    // Idle pipes for splice transfers; a pipe goes back here only when empty.
+    struct pipe_pair {
+        int r;
+        int w;
+        uint32_t size;
+    };
+    std::vector<pipe_pair> pipes;
+
+    // Op slots of the splice transfers in flight, for cancel by fd.
+    std::vector<uint32_t> splices;
+
+    // Live op slots by target fd, for cancel by fd without a slab scan.
+    std::vector<std::vector<uint32_t>> fd_ops;
+
+    // user_data of the requests a cancel call is about to cancel.
+    std::vector<uint64_t> cancel_targets;
+
+    // Pending submit_timer requests: timer_id -> op slot, for cancel_timer.
+    std::unordered_map<uint64_t, uint32_t> timers;
+
+    bee::async::async_stats stats;
+
+    // post without IORING_OP_MSG_RING (before 5.18): posters push onto a
+    // lock-free stack and ring post_efd, which a POLL_ADD in this ring
+    // watches; collected values wait in posted until there is room.
+    struct post_node {
+        post_node* next;
+        uint64_t request_id;
+    };
+    bool msg_ring    = false;  // IORING_OP_MSG_RING is supported
+    int post_efd     = -1;
+    bool post_armed  = false;  // a POLL_ADD on post_efd is in flight
+    std::atomic<post_node*> posts { nullptr };
+    std::deque<bee::async::io_completion> posted;
+
+    // Registered file table, created on the first register_fd.  fixed_slot
+    // maps fd -> table index (-1 if the fd is not registered).
+    uint32_t file_table_size = 0;
+    bool files_registered    = false;
+    std::vector<int32_t> fixed_slot;
+    std::vector<uint32_t> free_file_slots;
 };
 
 namespace bee::async {
 
-    static constexpr uint32_t kEntries = 256;
+    static constexpr uint32_t kEntries       = 256;
+    static constexpr uint32_t kFileTableSize = 1024;
+
+    // Setup flags that only tune scheduling; dropped if the kernel rejects them.
+    static constexpr uint32_t kOptionalSetupFlags = BEE__IORING_SETUP_COOP_TASKRUN | BEE__IORING_SETUP_TASKRUN_FLAG | BEE__IORING_SETUP_SINGLE_ISSUER | BEE__IORING_SETUP_DEFER_TASKRUN;
 
-    // Pack op type into the high 8 bits of user_data; request_id uses the low 56 bits.
-    static constexpr uint64_t kOpShift = 56;
-    static constexpr uint64_t kIdMask  = (uint64_t(1) << kOpShift) - 1;
+    // Pack op type into the high 8 bits of user_data; the uring_op slot index
+    // uses the low 32 bits (internal timeout/cancel SQEs carry no slot).
+    static constexpr uint64_t kOpShift  = 56;
+    static constexpr uint64_t kSlotMask = 0xFFFFFFFF;
 
-    static inline uint64_t pack_user_data(async_op op, uint64_t request_id) noexcept {
-        return (static_cast<uint64_t>(op) << kOpShift) | (request_id & kIdMask);
+    static inline uint64_t pack_user_data(async_op op, uint32_t slot) noexcept {
+        return (static_cast<uint64_t>(op) << kOpShift) | slot;
     }
 
     static inline async_op unpack_op(uint64_t user_data) noexcept {
         return static_cast<async_op>(user_data >> kOpShift);
     }
 
-    static inline uint64_t unpack_id(uint64_t user_data) noexcept {
-        return user_data & kIdMask;
+    static inline uint32_t unpack_slot(uint64_t user_data) noexcept {
+        return static_cast<uint32_t>(user_data & kSlotMask);
     }
 
+    // A posted value takes the whole user_data below the op type.
+    static constexpr uint64_t kPostMask = (uint64_t(1) << kOpShift) - 1;
+
     // ---- atomic helpers (matching libuv's acquire/release ordering) ----
 
     static inline uint32_t load_acquire(const uint32_t* p) noexcept {
@@ -248,15 +498,39 @@ namespace bee::async {
 
     // ---- ring init / exit ----
 
-    static bool uring_init(uint32_t entries, io_uring* ring) noexcept {
-        bee__io_uring_params params;
+    static int uring_setup(uint32_t entries, const async_options& options, uint32_t flags, bee__io_uring_params& params) noexcept {
         memset(&params, 0, sizeof(params));
+        params.flags = flags;
+        if (options.cq_entries != 0) {
+            params.flags |= BEE__IORING_SETUP_CQSIZE | BEE__IORING_SETUP_CLAMP;
+            params.cq_entries = options.cq_entries;
+        }
+        if (flags & BEE__IORING_SETUP_SQPOLL) {
+            params.sq_thread_idle = options.sqpoll_idle;
+        }
+        return sys_io_uring_setup(entries, &params);
+    }
+
+    static bool uring_init(const async_options& options, io_uring* ring) noexcept {
+        uint32_t entries = options.entries != 0 ? options.entries : kEntries;
+        uint32_t flags   = 0;
+        if (options.sqpoll) flags |= BEE__IORING_SETUP_SQPOLL;
+        if (options.coop_taskrun) flags |= BEE__IORING_SETUP_COOP_TASKRUN | BEE__IORING_SETUP_TASKRUN_FLAG;
+        if (options.single_issuer) flags |= BEE__IORING_SETUP_SINGLE_ISSUER;
+        if (options.defer_taskrun) flags |= BEE__IORING_SETUP_SINGLE_ISSUER | BEE__IORING_SETUP_DEFER_TASKRUN;
 
         // On kernel 6.6+ the kernel can omit the sq_array indirection via
         // IORING_SETUP_NO_SQARRAY.  We intentionally do not request that flag here:
         // unknown setup flags may be rejected on older kernels, and the existing
         // sq_array initialisation path already works for both layouts.
-        int ringfd = sys_io_uring_setup(entries, &params);
+        //
+        // The task-run flags are pure scheduling hints and are rejected by older
+        // kernels (or in combination with SQPOLL); retry without them.
+        bee__io_uring_params params;
+        int ringfd = uring_setup(entries, options, flags, params);
+        if (ringfd < 0 && errno == EINVAL && (flags & kOptionalSetupFlags)) {
+            ringfd = uring_setup(entries, options, flags & ~kOptionalSetupFlags, params);
+        }
         if (ringfd < 0) return false;
 
         // Require only the features that are actually used below:
@@ -293,11 +567,21 @@ namespace bee::async {
             return false;
         }
 
-        ring->ringfd = ringfd;
-        ring->sq     = sq;
-        ring->maxlen = maxlen;
-        ring->sqe    = sqe_ptr;
-        ring->sqelen = sqelen;
+        ring->ringfd      = ringfd;
+        ring->sq          = sq;
+        ring->maxlen      = maxlen;
+        ring->sqe         = sqe_ptr;
+        ring->sqelen      = sqelen;
+        ring->setup_flags = params.flags;
+
+        // The table must also fit under RLIMIT_NOFILE or registration fails with EMFILE.
+        uint32_t files = options.files != 0 ? options.files : kFileTableSize;
+        struct rlimit rl;
+        if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY && rl.rlim_cur < files) {
+            files = static_cast<uint32_t>(rl.rlim_cur);
+        }
+        ring->file_table_size = files;
+        ring->zc_threshold    = options.zerocopy_threshold;
 
         ring->sqhead  = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
         ring->sqtail  = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
@@ -327,20 +611,172 @@ namespace bee::async {
         munmap(ring->sq, ring->maxlen);
         close(ring->ringfd);
         ring->ringfd = -1;
+        // The kernel drops its buffer ring registrations together with the ring fd.
+        for (auto& br : ring->buf_rings) {
+            munmap(br->bufs, br->ringlen);
+        }
+        ring->buf_rings.clear();
+        for (auto& p : ring->pipes) {
+            close(p.r);
+            close(p.w);
+        }
+        ring->pipes.clear();
+        for (uint32_t i = 0; i < ring->ops.capacity(); ++i) {
+            auto& sp = ring->ops[i].sp;
+            if (sp.pipe_r >= 0) {
+                close(sp.pipe_r);
+                close(sp.pipe_w);
+                sp.pipe_r = sp.pipe_w = -1;
+            }
+        }
+        if (ring->post_efd >= 0) {
+            close(ring->post_efd);
+            ring->post_efd = -1;
+        }
+        for (io_uring::post_node* node = ring->posts.exchange(nullptr); node;) {
+            io_uring::post_node* next = node->next;
+            delete node;
+            node = next;
+        }
+        ring->posted.clear();
+    }
+
+    // ---- provided-buffer rings ----
+
+    // Hand buffer bid back to the kernel.  Only addr/len/bid are written: the
+    // resv field of entry 0 doubles as the ring tail.
+    static inline void pbuf_ring_add(pbuf_ring* br, uint16_t bid) noexcept {
+        bee__io_uring_buf* buf = &br->bufs[br->tail & br->mask];
+        buf->addr              = reinterpret_cast<uintptr_t>(br->pool.buffer(bid));
+        buf->len               = static_cast<uint32_t>(br->pool.buf_size());
+        buf->bid               = bid;
+        br->tail++;
+    }
+
+    static inline void pbuf_ring_publish(pbuf_ring* br) noexcept {
+        uint16_t* tail = reinterpret_cast<uint16_t*>(reinterpret_cast<char*>(br->bufs) + 14);
+        __atomic_store_n(tail, br->tail, __ATOMIC_RELEASE);
+    }
+
+    // ---- io_uring_enter ----
+
+    // Return the number of SQEs published but not yet consumed by the kernel.
+    static inline uint32_t uring_pending(const io_uring* ring) noexcept {
+        return *ring->sqtail - load_acquire(ring->sqhead);
+    }
+
+    // io_uring_enter with EINTR retry.  Under SQPOLL the kernel thread does
+    // the submitting: to_submit only matters for waking it up, and a call
+    // that neither waits nor wakes the thread is skipped entirely.
+    static int uring_enter(io_uring* ring, uint32_t to_submit, uint32_t min_complete, uint32_t flags, const void* arg = nullptr) noexcept {
+        if (ring->setup_flags & BEE__IORING_SETUP_SQPOLL) {
+            if (to_submit > 0 && (load_acquire(ring->sqflags) & BEE__IORING_SQ_NEED_WAKEUP)) {
+                flags |= BEE__IORING_ENTER_SQ_WAKEUP;
+            }
+            if (!(flags & (BEE__IORING_ENTER_GETEVENTS | BEE__IORING_ENTER_SQ_WAKEUP | BEE__IORING_ENTER_SQ_WAIT))) {
+                return 0;
+            }
+        }
+        int ret;
+        do {
+            ring->stats.enter_calls++;
+            ret = sys_io_uring_enter(ring->ringfd, to_submit, min_complete, flags, arg);
+        } while (ret == -1 && errno == EINTR);
+        return ret;
+    }
+
+    // With DEFER_TASKRUN completions are only posted from io_uring_enter, and
+    // with COOP_TASKRUN they may wait for the next kernel transition; in
+    // both cases a non-blocking poll must enter the kernel to see them.
+    static inline bool uring_needs_getevents(const io_uring* ring) noexcept {
+        if (ring->setup_flags & BEE__IORING_SETUP_DEFER_TASKRUN) return true;
+        return (load_acquire(ring->sqflags) & BEE__IORING_SQ_TASKRUN) != 0;
+    }
+
+    // ---- registered file table ----
+
+    static bool uring_files_update(io_uring* ring, uint32_t slot, int32_t fd) noexcept {
+        bee__io_uring_files_update up;
+        memset(&up, 0, sizeof(up));
+        up.offset = slot;
+        up.fds    = reinterpret_cast<uintptr_t>(&fd);
+        return sys_io_uring_register(ring->ringfd, BEE__IORING_REGISTER_FILES_UPDATE, &up, 1) == 1;
+    }
+
+    // Register an all-empty (-1) table once; slots are filled by FILES_UPDATE.
+    static bool uring_files_init(io_uring* ring) {
+        if (ring->files_registered) return true;
+        if (ring->file_table_size == 0) return false;
+        std::vector<int32_t> fds(ring->file_table_size, -1);
+        if (sys_io_uring_register(ring->ringfd, BEE__IORING_REGISTER_FILES, fds.data(), ring->file_table_size) < 0) {
+            ring->file_table_size = 0;  // unsupported or over the limit: stay on plain fds
+            return false;
+        }
+        ring->free_file_slots.reserve(ring->file_table_size);
+        for (uint32_t i = ring->file_table_size; i > 0; --i) {
+            ring->free_file_slots.push_back(i - 1);
+        }
+        ring->files_registered = true;
+        return true;
+    }
+
+    static bool uring_register_fd(io_uring* ring, int fd) {
+        if (fd < 0) return false;
+        size_t idx = static_cast<size_t>(fd);
+        if (idx < ring->fixed_slot.size() && ring->fixed_slot[idx] >= 0) return true;
+        if (!uring_files_init(ring) || ring->free_file_slots.empty()) return false;
+        uint32_t slot = ring->free_file_slots.back();
+        if (!uring_files_update(ring, slot, fd)) return false;
+        ring->free_file_slots.pop_back();
+        if (idx >= ring->fixed_slot.size()) {
+            ring->fixed_slot.resize(std::max(idx + 1, ring->fixed_slot.size() * 2), -1);
+        }
+        ring->fixed_slot[idx] = static_cast<int32_t>(slot);
+        return true;
+    }
+
+    static void uring_unregister_fd(io_uring* ring, int fd) {
+        size_t idx = static_cast<size_t>(fd);
+        if (fd < 0 || idx >= ring->fixed_slot.size() || ring->fixed_slot[idx] < 0) return;
+        uint32_t slot = static_cast<uint32_t>(ring->fixed_slot[idx]);
+        // Requests already in flight hold their own file reference.
+        uring_files_update(ring, slot, -1);
+        ring->fixed_slot[idx] = -1;
+        ring->free_file_slots.push_back(slot);
+    }
+
+    // Target fd with sqe, through the fixed table when fd is registered.
+    static inline void uring_sqe_set_fd(const io_uring* ring, bee__io_uring_sqe* sqe, int fd) noexcept {
+        size_t idx = static_cast<size_t>(fd);
+        if (fd >= 0 && idx < ring->fixed_slot.size() && ring->fixed_slot[idx] >= 0) {
+            sqe->fd = ring->fixed_slot[idx];
+            sqe->flags |= BEE__IOSQE_FIXED_FILE;
+        } else {
+            sqe->fd = fd;
+        }
     }
 
     // ---- SQE helpers ----
 
-    // Returns the next free SQE slot, or nullptr if the SQ is full.
+    // Returns the next free SQE slot.  A full SQ is handed to the kernel and
+    // the slot claimed again; nullptr only if the kernel could not make room.
     // The caller fills the SQE and then calls uring_submit().
-    static inline bee__io_uring_sqe* uring_get_sqe(io_uring* ring) noexcept {
+    // n > 1 reserves room for n consecutive SQEs (an op and its linked timeout).
+    static inline bee__io_uring_sqe* uring_get_sqe(io_uring* ring, uint32_t n = 1) noexcept {
         uint32_t head = load_acquire(ring->sqhead);
         uint32_t tail = *ring->sqtail;
         uint32_t mask = ring->sqmask;
 
         // Ring is full only when the number of in-flight SQEs reaches capacity.
-        if ((tail - head) >= (mask + 1))
-            return nullptr;
+        if ((tail - head) + n > (mask + 1)) {
+            uint32_t flags = (ring->setup_flags & BEE__IORING_SETUP_SQPOLL) ? BEE__IORING_ENTER_SQ_WAIT : 0;
+            uring_enter(ring, tail - head, 0, flags);
+            head = load_acquire(ring->sqhead);
+            if ((tail - head) + n > (mask + 1)) {
+                ring->stats.submit_failures++;
+                return nullptr;
+            }
+        }
 
         uint32_t slot         = tail & mask;
         bee__io_uring_sqe* sqe = &ring->sqe[slot];
@@ -354,9 +790,434 @@ namespace bee::async {
         store_release(ring->sqtail, *ring->sqtail + 1);
     }
 
-    // Return the number of SQEs published but not yet consumed by the kernel.
-    static inline uint32_t uring_pending(const io_uring* ring) noexcept {
-        return *ring->sqtail - load_acquire(ring->sqhead);
+    // Publish sqe for op slot, followed by an IORING_OP_LINK_TIMEOUT when
+    // timeout (ms) is not negative.  Both SQEs become visible with one tail
+    // update so an SQPOLL thread can never see the link half built.  The
+    // caller must have reserved two SQEs.
+    static inline void uring_submit_deadline(io_uring* ring, bee__io_uring_sqe* sqe, uint32_t slot, async_op op, int timeout) noexcept {
+        if (timeout < 0) {
+            uring_submit(ring);
+            return;
+        }
+        uring_op& ctx  = ring->ops[slot];
+        ctx.linked     = true;
+        ctx.op_done    = false;
+        ctx.lt_done    = false;
+        ctx.timed_out  = false;
+        ctx.op         = op;
+        ctx.ts.tv_sec  = timeout / 1000;
+        ctx.ts.tv_nsec = static_cast<int64_t>(timeout % 1000) * 1000000L;
+        sqe->flags |= BEE__IOSQE_IO_LINK;
+
+        uint32_t tail         = *ring->sqtail;
+        bee__io_uring_sqe* lt = &ring->sqe[(tail + 1) & ring->sqmask];
+        memset(lt, 0, sizeof(*lt));
+        lt->opcode    = BEE__IORING_OP_LINK_TIMEOUT;
+        lt->addr      = reinterpret_cast<uintptr_t>(&ctx.ts);
+        lt->len       = 1;
+        lt->user_data = pack_user_data(async_op::link_timeout, slot);
+        store_release(ring->sqtail, tail + 2);
+    }
+
+    // Claim an op context for request_id.  Call only once an SQE has been
+    // obtained, so a full SQ never leaks a slot.
+    static inline uint32_t uring_op_alloc(io_uring* ring, uint64_t request_id, async_op op) {
+        uint32_t slot              = ring->ops.alloc();
+        ring->ops[slot].request_id = request_id;
+        ring->ops[slot].op         = op;
+        ring->ops[slot].fd         = -1;
+        ring->ops[slot].live       = true;
+        ring->ops[slot].zc         = false;
+        ring->ops[slot].linked     = false;
+        ring->ops[slot].submitted  = std::chrono::steady_clock::now();
+        ring->stats.submitted(op);
+        return slot;
+    }
+
+    // Drop slot from the fd_ops list of its fd.
+    static inline void uring_op_unlink_fd(io_uring* ring, uint32_t slot) noexcept {
+        uring_op& ctx = ring->ops[slot];
+        if (ctx.fd < 0) return;
+        auto& list             = ring->fd_ops[static_cast<size_t>(ctx.fd)];
+        uint32_t last          = list.back();
+        list[ctx.fd_pos]       = last;
+        ring->ops[last].fd_pos = ctx.fd_pos;
+        list.pop_back();
+        ctx.fd = -1;
+    }
+
+    // Release the op context once its request is finished.
+    static inline void uring_op_free(io_uring* ring, uint32_t slot) noexcept {
+        uring_op_unlink_fd(ring, slot);
+        ring->ops[slot].live = false;
+        ring->ops.free(slot);
+    }
+
+    // Give back a slot whose request never reached the kernel.
+    static inline void uring_op_discard(io_uring* ring, uint32_t slot, async_op op) {
+        ring->stats.submits[static_cast<size_t>(op)]--;
+        ring->stats.submit_failures++;
+        uring_op_free(ring, slot);
+    }
+
+    // Target sqe of the op in slot at fd, and remember fd for cancel.
+    static inline void uring_op_set_fd(io_uring* ring, bee__io_uring_sqe* sqe, uint32_t slot, int fd) {
+        uring_op_unlink_fd(ring, slot);
+        uring_sqe_set_fd(ring, sqe, fd);
+        if (fd < 0) return;
+        size_t idx = static_cast<size_t>(fd);
+        if (idx >= ring->fd_ops.size()) {
+            ring->fd_ops.resize(std::max(idx + 1, ring->fd_ops.size() * 2));
+        }
+        auto& list             = ring->fd_ops[idx];
+        ring->ops[slot].fd     = fd;
+        ring->ops[slot].fd_pos = static_cast<uint32_t>(list.size());
+        list.push_back(slot);
+    }
+
+    // Point ctx.msg at a private copy of bufs; the caller's iov array does not
+    // outlive the submit call.
+    static inline void uring_op_set_iov(uring_op& ctx, bee::span<const bee::net::socket::iobuf> bufs) {
+        ctx.bufs.assign(bufs.begin(), bufs.end());
+        ctx.msg            = {};
+        ctx.msg.msg_iov    = reinterpret_cast<struct iovec*>(ctx.bufs.data());
+        ctx.msg.msg_iovlen = ctx.bufs.size();
+    }
+
+    // Issue ctx's message again as a plain SENDMSG after SENDMSG_ZC was
+    // rejected: EINVAL means the kernel lacks the opcode, EOPNOTSUPP that this
+    // socket type cannot do zero-copy.
+    static bool uring_resubmit_copy(io_uring* ring, uint32_t slot, bool unsupported) noexcept {
+        if (unsupported) ring->zc_threshold = 0;
+        uring_op& ctx          = ring->ops[slot];
+        bee__io_uring_sqe* sqe = uring_get_sqe(ring);
+        if (!sqe) return false;
+        ctx.zc         = false;
+        sqe->opcode    = BEE__IORING_OP_SENDMSG;
+        sqe->addr      = reinterpret_cast<uintptr_t>(&ctx.msg);
+        sqe->len       = 1;
+        sqe->msg_flags = 0;
+        sqe->user_data = pack_user_data(async_op::write, slot);
+        uring_sqe_set_fd(ring, sqe, ctx.fd);
+        uring_submit(ring);
+        return true;
+    }
+
+    // ---- splice transfers ----
+
+    static constexpr int kSplicePipeSize = 1 << 20;
+
+    static bool uring_pipe_get(io_uring* ring, uring_op::splice_state& sp) {
+        if (!ring->pipes.empty()) {
+            auto p = ring->pipes.back();
+            ring->pipes.pop_back();
+            sp.pipe_r    = p.r;
+            sp.pipe_w    = p.w;
+            sp.pipe_size = p.size;
+            return true;
+        }
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC) != 0) return false;
+        // A bigger pipe means fewer splice pairs per transfer; the kernel
+        // caps it at /proc/sys/fs/pipe-max-size.
+        fcntl(fds[1], F_SETPIPE_SZ, kSplicePipeSize);
+        int size     = fcntl(fds[1], F_GETPIPE_SZ);
+        sp.pipe_r    = fds[0];
+        sp.pipe_w    = fds[1];
+        sp.pipe_size = size > 0 ? static_cast<uint32_t>(size) : 65536;
+        return true;
+    }
+
+    // Keep an empty pipe for the next transfer; one still holding data is closed.
+    static void uring_pipe_put(io_uring* ring, uring_op::splice_state& sp) {
+        if (sp.pipe_r < 0) return;
+        if (sp.piped == 0) {
+            ring->pipes.push_back({ sp.pipe_r, sp.pipe_w, sp.pipe_size });
+        } else {
+            close(sp.pipe_r);
+            close(sp.pipe_w);
+        }
+        sp.pipe_r = -1;
+        sp.pipe_w = -1;
+    }
+
+    static inline void uring_prep_splice(bee__io_uring_sqe* sqe, int in, int64_t in_off, int out, uint32_t len, uint64_t user_data) noexcept {
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode        = BEE__IORING_OP_SPLICE;
+        sqe->splice_fd_in  = in;
+        sqe->splice_off_in = static_cast<uint64_t>(in_off);
+        sqe->fd            = out;
+        sqe->off           = static_cast<uint64_t>(-1);
+        sqe->len           = len;
+        sqe->user_data     = user_data;
+    }
+
+    // POLL_ADD linked in front of a socket splice.  io_uring runs SPLICE on
+    // a worker thread, which returns -EAGAIN for a nonblocking socket
+    // instead of waiting for it.
+    static inline void uring_prep_splice_poll(bee__io_uring_sqe* sqe, int fd, uint32_t events, uint32_t slot) noexcept {
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode    = BEE__IORING_OP_POLL_ADD;
+        sqe->fd        = fd;
+        sqe->rw_flags  = events;
+        sqe->flags     = BEE__IOSQE_IO_LINK;
+        sqe->user_data = pack_user_data(async_op::splice_poll, slot);
+    }
+
+    // Queue the next step of the transfer in slot:
+    //  - flush what is left in the pipe, first waiting for POLLOUT when the
+    //    last attempt found dst full (wait_out);
+    //  - socket source: wait for POLLIN, then a lone splice_in;
+    //  - file source: a linked splice_in + op pair.
+    static bool uring_splice_next(io_uring* ring, uint32_t slot, bool wait_out) noexcept {
+        uring_op& ctx = ring->ops[slot];
+        auto& sp      = ctx.sp;
+        uint32_t tail = *ring->sqtail;
+        uint32_t n    = (sp.piped > 0 && !wait_out) ? 1 : 2;
+        bee__io_uring_sqe* sqe = uring_get_sqe(ring, n);
+        if (!sqe) return false;
+        bee__io_uring_sqe* next = &ring->sqe[(tail + 1) & ring->sqmask];
+        sp.poll_res = 0;
+        if (sp.piped > 0) {
+            if (wait_out) {
+                uring_prep_splice_poll(sqe, sp.dst, POLLOUT, slot);
+                sqe = next;
+            }
+            uring_prep_splice(sqe, sp.pipe_r, -1, sp.dst, sp.piped, pack_user_data(ctx.op, slot));
+            sp.paired = false;
+        } else {
+            sp.chunk  = static_cast<uint32_t>(std::min<uint64_t>(sp.remaining, sp.pipe_size));
+            sp.in_res = 0;
+            if (sp.src_off < 0) {
+                uring_prep_splice_poll(sqe, sp.src, POLLIN, slot);
+                uring_prep_splice(next, sp.src, -1, sp.pipe_w, sp.chunk, pack_user_data(async_op::splice_in, slot));
+                sp.paired = false;
+            } else {
+                uring_prep_splice(sqe, sp.src, sp.src_off, sp.pipe_w, sp.chunk, pack_user_data(async_op::splice_in, slot));
+                sqe->flags |= BEE__IOSQE_IO_LINK;
+                uring_prep_splice(next, sp.pipe_r, -1, sp.dst, sp.chunk, pack_user_data(ctx.op, slot));
+                sp.paired = true;
+            }
+        }
+        store_release(ring->sqtail, tail + n);
+        return true;
+    }
+
+    // Start the transfer in slot once the caller has set src, dst, src_off
+    // and remaining.
+    static bool uring_splice_start(io_uring* ring, uint32_t slot, async_op op) {
+        uring_op& ctx   = ring->ops[slot];
+        ctx.op          = op;
+        ctx.sp.total    = 0;
+        ctx.sp.piped    = 0;
+        ctx.sp.canceled = false;
+        if (!uring_pipe_get(ring, ctx.sp)) {
+            uring_op_discard(ring, slot, op);
+            return false;
+        }
+        if (!uring_splice_next(ring, slot, false)) {
+            uring_pipe_put(ring, ctx.sp);
+            uring_op_discard(ring, slot, op);
+            return false;
+        }
+        ring->splices.push_back(slot);
+        return true;
+    }
+
+    // Continue after a CQE of the transfer, or end it.  Returns true once the
+    // transfer is over, with err = 0 or a negative errno.
+    static bool uring_splice_continue(io_uring* ring, uint32_t slot, bool wait_out, int32_t& err) noexcept {
+        auto& sp = ring->ops[slot].sp;
+        if (err == 0 && sp.canceled) err = -ECANCELED;
+        if (err == 0 && (sp.piped > 0 || sp.remaining > 0)) {
+            if (uring_splice_next(ring, slot, wait_out)) return false;
+            err = -EAGAIN;
+        }
+        uring_pipe_put(ring, sp);
+        return true;
+    }
+
+    // splice_poll CQE: only a failure matters; the linked splice then
+    // completes with -ECANCELED.
+    static void uring_splice_poll(uring_op::splice_state& sp, int32_t res) noexcept {
+        if (res < 0) sp.poll_res = res;
+    }
+
+    // splice_in CQE: the bytes it moved are now in the pipe.  Paired with a
+    // file source the op CQE follows; a lone splice_in (socket source)
+    // drives the transfer itself and 0 means src hit EOF.
+    static bool uring_splice_in(io_uring* ring, uint32_t slot, int32_t res, int32_t& err) noexcept {
+        auto& sp  = ring->ops[slot].sp;
+        err       = 0;
+        sp.in_res = res;
+        if (res > 0) {
+            sp.piped += static_cast<uint32_t>(res);
+            sp.remaining -= static_cast<uint64_t>(res);
+            if (sp.src_off >= 0) sp.src_off += res;
+        }
+        if (sp.paired) return false;
+        if (res == 0) {
+            sp.remaining = 0;
+        } else if (res == -ECANCELED && sp.poll_res < 0) {
+            err = sp.poll_res;
+        } else if (res < 0 && res != -EAGAIN) {
+            err = res;
+        }
+        return uring_splice_continue(ring, slot, false, err);
+    }
+
+    // CQE of the pipe -> dst splice.
+    static bool uring_splice_advance(io_uring* ring, uint32_t slot, int32_t res, int32_t& err) noexcept {
+        auto& sp      = ring->ops[slot].sp;
+        err           = 0;
+        bool wait_out = false;
+        if (res > 0) {
+            sp.total += static_cast<uint64_t>(res);
+            sp.piped -= static_cast<uint32_t>(res);
+        } else if (res == -EAGAIN) {
+            wait_out = true;  // dst is full
+        } else if (res == -ECANCELED && sp.paired && sp.in_res >= 0 && static_cast<uint32_t>(sp.in_res) < sp.chunk) {
+            // A short splice_in broke the link; zero means src hit EOF.
+            if (sp.in_res == 0) sp.remaining = 0;
+        } else if (res == -ECANCELED && sp.paired && sp.in_res < 0) {
+            err = sp.in_res;
+        } else if (res == -ECANCELED && sp.poll_res < 0) {
+            err = sp.poll_res;
+        } else if (res == 0) {
+            sp.remaining = 0;
+            sp.piped     = 0;
+        } else {
+            err = res;
+        }
+        return uring_splice_continue(ring, slot, wait_out, err);
+    }
+
+    // Fill c for the finished transfer in slot and free the slot.
+    static void uring_splice_finish(io_uring* ring, uint32_t slot, int32_t err, io_completion& c) noexcept {
+        uring_op& ctx = ring->ops[slot];
+        ring->stats.completed(ctx.op, ctx.submitted, std::chrono::steady_clock::now());
+        c.op                = ctx.op;
+        c.request_id        = ctx.request_id;
+        c.more              = false;
+        c.buffer_id         = -1;
+        c.status            = err == 0 ? async_status::success : err == -ECANCELED ? async_status::cancel : async_status::error;
+        c.bytes_transferred = static_cast<size_t>(ctx.sp.total);
+        c.error_code        = (err == 0 || err == -ECANCELED) ? 0 : -err;
+        auto& v             = ring->splices;
+        auto it             = std::find(v.begin(), v.end(), slot);
+        if (it != v.end()) {
+            *it = v.back();
+            v.pop_back();
+        }
+        uring_op_free(ring, slot);
+    }
+
+    // Queue an ASYNC_CANCEL for each user_data in cancel_targets and publish
+    // them with one tail update, or one per SQ-full when there are more.
+    static void uring_submit_cancels(io_uring* ring) noexcept {
+        const auto& targets = ring->cancel_targets;
+        uint32_t cap        = ring->sqmask + 1;
+        for (size_t i = 0; i < targets.size();) {
+            uint32_t n = static_cast<uint32_t>(std::min<size_t>(targets.size() - i, cap));
+            if (!uring_get_sqe(ring, n)) break;
+            uint32_t tail = *ring->sqtail;
+            for (uint32_t k = 0; k < n; ++k) {
+                bee__io_uring_sqe* sqe = &ring->sqe[(tail + k) & ring->sqmask];
+                memset(sqe, 0, sizeof(*sqe));
+                sqe->opcode    = BEE__IORING_OP_ASYNC_CANCEL;
+                sqe->fd        = -1;
+                sqe->addr      = targets[i + k];
+                sqe->user_data = pack_user_data(async_op::cancel, 0);
+            }
+            store_release(ring->sqtail, tail + n);
+            i += n;
+        }
+        ring->cancel_targets.clear();
+    }
+
+    // A transfer is a sequence of SQEs, so cancel by fd would miss the
+    // halves that name the pipe.  Mark every transfer of kind op touching
+    // fd and cancel whatever it has in flight by user_data; the resulting
+    // CQE ends it with -ECANCELED.
+    static void uring_cancel_splices(io_uring* ring, net::fd_t fd, async_op op) {
+        for (uint32_t slot : ring->splices) {
+            uring_op& ctx = ring->ops[slot];
+            if (ctx.op != op || ctx.sp.canceled || (ctx.sp.src != fd && ctx.sp.dst != fd)) continue;
+            ctx.sp.canceled = true;
+            for (async_op part : { async_op::splice_poll, async_op::splice_in, op }) {
+                ring->cancel_targets.push_back(pack_user_data(part, slot));
+            }
+        }
+        uring_submit_cancels(ring);
+    }
+
+    // ---- cross-thread post without MSG_RING ----
+
+    // IORING_REGISTER_PROBE (5.6+) lists the opcodes the kernel knows.
+    static bool uring_probe_op(io_uring* ring, uint8_t opcode) noexcept {
+        constexpr unsigned kOps = 64;
+        struct {
+            bee__io_uring_probe hdr;
+            bee__io_uring_probe_op ops[kOps];
+        } probe;
+        memset(&probe, 0, sizeof(probe));
+        if (sys_io_uring_register(ring->ringfd, BEE__IORING_REGISTER_PROBE, &probe, kOps) < 0) return false;
+        return opcode < probe.hdr.ops_len && opcode < kOps && (probe.ops[opcode].flags & BEE__IO_URING_OP_SUPPORTED);
+    }
+
+    // Watch post_efd with a one-shot POLL_ADD; re-armed after each wakeup.
+    static void uring_post_arm(io_uring* ring) noexcept {
+        if (ring->post_efd < 0 || ring->post_armed) return;
+        bee__io_uring_sqe* sqe = uring_get_sqe(ring);
+        if (!sqe) return;  // retried by the next wait
+        sqe->opcode    = BEE__IORING_OP_POLL_ADD;
+        sqe->fd        = ring->post_efd;
+        sqe->rw_flags  = POLLIN;
+        sqe->user_data = pack_user_data(async_op::post_wake, 0);
+        uring_submit(ring);
+        ring->post_armed = true;
+    }
+
+    // The eventfd fired: reset it before taking the stack, so a value
+    // pushed after the swap rings it again, and queue the values in
+    // posting order.
+    static void uring_post_collect(io_uring* ring) noexcept {
+        ring->post_armed = false;
+        uint64_t value;
+        [[maybe_unused]] ssize_t r = read(ring->post_efd, &value, sizeof(value));
+        io_uring::post_node* node  = ring->posts.exchange(nullptr, std::memory_order_acquire);
+        io_uring::post_node* fifo  = nullptr;
+        while (node) {
+            io_uring::post_node* next = node->next;
+            node->next                = fifo;
+            fifo                      = node;
+            node                      = next;
+        }
+        while (fifo) {
+            io_uring::post_node* next = fifo->next;
+            io_completion c;
+            c.request_id        = fifo->request_id;
+            c.op                = async_op::post;
+            c.status            = async_status::success;
+            c.bytes_transferred = 0;
+            c.error_code        = 0;
+            c.buffer_id         = -1;
+            c.more              = false;
+            ring->posted.push_back(c);
+            delete fifo;
+            fifo = next;
+        }
+        uring_post_arm(ring);
+    }
+
+    // Hand out collected values while completions has room.
+    static uint32_t uring_post_drain(io_uring* ring, const span<io_completion>& completions, uint32_t count) noexcept {
+        while (!ring->posted.empty() && count < static_cast<uint32_t>(completions.size())) {
+            completions[count++] = ring->posted.front();
+            ring->posted.pop_front();
+            ring->stats.completions[static_cast<size_t>(async_op::post)]++;
+        }
+        return count;
     }
 
     // ---- CQE harvesting ----
@@ -366,31 +1227,131 @@ namespace bee::async {
         uint32_t head  = *ring->cqhead;
         uint32_t tail  = load_acquire(ring->cqtail);
         uint32_t mask  = ring->cqmask;
-        uint32_t count = 0;
+        uint32_t count = uring_post_drain(ring, completions, 0);
+        auto now       = head != tail ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point {};
 
         while (head != tail && count < static_cast<uint32_t>(completions.size())) {
             const bee__io_uring_cqe& cqe = ring->cqes[head & mask];
-            // Skip internal timeout CQEs — they are never surfaced to the caller.
-            if (unpack_op(cqe.user_data) == async_op::timeout) {
+            // Skip internal timeout/cancel CQEs — they are never surfaced to the caller.
+            if (unpack_op(cqe.user_data) == async_op::timeout || unpack_op(cqe.user_data) == async_op::cancel) {
                 head++;
                 continue;
             }
-            io_completion& c            = completions[count++];
-            c.op                        = unpack_op(cqe.user_data);
-            c.request_id                = unpack_id(cqe.user_data);
-            // Free the I/O context (msghdr + iobuf array) once the CQE arrives.
-            if (c.op == async_op::write || c.op == async_op::read) {
-                ring->io_pending.erase(c.request_id);
+            async_op op    = unpack_op(cqe.user_data);
+            uint32_t slot  = unpack_slot(cqe.user_data);
+            int32_t res    = cqe.res;
+            uint32_t flags = cqe.flags;
+            if (op == async_op::post) {
+                // Posted by IORING_OP_MSG_RING from another ring: no op context.
+                io_completion& c    = completions[count++];
+                c.op                = op;
+                c.request_id        = cqe.user_data & kPostMask;
+                c.status            = async_status::success;
+                c.bytes_transferred = 0;
+                c.error_code        = 0;
+                c.buffer_id         = -1;
+                c.more              = false;
+                ring->stats.completions[static_cast<size_t>(op)]++;
+                head++;
+                continue;
+            }
+            if (op == async_op::post_wake) {
+                uring_post_collect(ring);
+                count = uring_post_drain(ring, completions, count);
+                head++;
+                continue;
+            }
+            if (op == async_op::splice_poll) {
+                uring_splice_poll(ring->ops[slot].sp, res);
+                head++;
+                continue;
+            }
+            if (op == async_op::splice_in || op == async_op::sendfile || op == async_op::relay) {
+                int32_t err;
+                bool done = op == async_op::splice_in ? uring_splice_in(ring, slot, res, err) : uring_splice_advance(ring, slot, res, err);
+                if (done) uring_splice_finish(ring, slot, err, completions[count++]);
+                head++;
+                continue;
+            }
+            if (op == async_op::link_timeout) {
+                // -ETIME: the deadline fired and cancelled the op.  Surface
+                // the op here if its own CQE came first.
+                uring_op& ctx = ring->ops[slot];
+                ctx.lt_done   = true;
+                if (res == -ETIME) ctx.timed_out = true;
+                if (!ctx.op_done) {
+                    head++;
+                    continue;
+                }
+                op    = ctx.op;
+                res   = ctx.res;
+                flags = 0;
+            } else if (ring->ops[slot].linked && !ring->ops[slot].lt_done) {
+                uring_op& ctx = ring->ops[slot];
+                ctx.op_done   = true;
+                ctx.res       = res;
+                head++;
+                continue;
+            } else if (ring->ops[slot].zc) {
+                // A zero-copy send posts its result with F_MORE, then a
+                // notification once the kernel no longer references the
+                // buffers.  Only the notification is surfaced, carrying the
+                // stored result, so the caller may free the data right away.
+                uring_op& ctx = ring->ops[slot];
+                if (cqe.flags & BEE__IORING_CQE_F_NOTIF) {
+                    res = ctx.res;
+                } else if (cqe.flags & BEE__IORING_CQE_F_MORE) {
+                    ctx.res = res;
+                    head++;
+                    continue;
+                } else if ((res == -EINVAL || res == -EOPNOTSUPP) && uring_resubmit_copy(ring, slot, res == -EINVAL)) {
+                    head++;
+                    continue;
+                }
+            }
+            bool timed_out   = ring->ops[slot].linked && ring->ops[slot].timed_out;
+            io_completion& c = completions[count++];
+            c.op             = op;
+            c.request_id     = ring->ops[slot].request_id;
+            c.more           = (flags & BEE__IORING_CQE_F_MORE) != 0;
+            c.buffer_id      = (flags & BEE__IORING_CQE_F_BUFFER) ? static_cast<int32_t>(flags >> BEE__IORING_CQE_BUFFER_SHIFT) : -1;
+            if (c.op == async_op::recv && c.buffer_id >= 0) {
+                ring->buf_rings[ring->ops[slot].group]->pool.take(static_cast<uint16_t>(c.buffer_id));
+            }
+            if (c.op == async_op::recvfrom && res >= 0) {
+                uring_op& ctx          = ring->ops[slot];
+                *ctx.ep->out_addrlen() = ctx.msg.msg_namelen;
+                for (struct cmsghdr* cm = CMSG_FIRSTHDR(&ctx.msg); cm; cm = CMSG_NXTHDR(&ctx.msg, cm)) {
+                    if (cm->cmsg_level == IPPROTO_UDP && cm->cmsg_type == UDP_GRO) {
+                        int segsize;
+                        memcpy(&segsize, CMSG_DATA(cm), sizeof(segsize));
+                        c.buffer_id = segsize;
+                    }
+                }
+            }
+            if (c.op == async_op::timer) {
+                // A pure timeout (count 0) completes with -ETIME on expiry.
+                ring->timers.erase(ring->ops[slot].timer_id);
+                if (res == -ETIME) res = 0;
+            }
+            ring->stats.completed(c.op, ring->ops[slot].submitted, now);
+            // Release the op context once its final CQE arrives.
+            if (!c.more) {
+                uring_op_free(ring, slot);
+            } else {
+                ring->ops[slot].submitted = now;
             }
             // For connect/file_write/accept/fd_poll, res==0 means success (not EOF).
             // For read/write (recv/send), res==0 means the peer closed the connection.
-            bool zero_is_success = (c.op == async_op::connect || c.op == async_op::write || c.op == async_op::file_write || c.op == async_op::accept || c.op == async_op::fd_poll);
-            if (cqe.res > 0) {
+            bool zero_is_success = (c.op == async_op::connect || c.op == async_op::write || c.op == async_op::file_write || c.op == async_op::accept || c.op == async_op::fd_poll || c.op == async_op::timer
+                                    || c.op == async_op::file_open || c.op == async_op::file_close || c.op == async_op::file_fsync || c.op == async_op::file_statx
+                                    || c.op == async_op::recvfrom || c.op == async_op::sendto);
+            if (res > 0) {
                 c.status            = async_status::success;
-                // For fd_poll, cqe.res is the revents mask (e.g. POLLIN=1), not a byte count.
-                c.bytes_transferred = (c.op == async_op::fd_poll) ? 0 : static_cast<size_t>(cqe.res);
+                // For fd_poll, res is the revents mask (e.g. POLLIN=1), not a byte count.
+                c.bytes_transferred = (c.op == async_op::fd_poll) ? 0 : static_cast<size_t>(res);
                 c.error_code        = 0;
-            } else if (cqe.res == 0) {
+            } else if (res == 0) {
                 if (zero_is_success) {
                     c.status            = async_status::success;
                     c.bytes_transferred = 0;
@@ -400,24 +1361,26 @@ namespace bee::async {
                     c.bytes_transferred = 0;
                     c.error_code        = 0;
                 }
+            } else if (res == -ECANCELED) {
+                c.status            = timed_out ? async_status::timeout : async_status::cancel;
+                c.bytes_transferred = 0;
+                c.error_code        = 0;
             } else {
                 c.status            = async_status::error;
                 c.bytes_transferred = 0;
-                c.error_code        = -cqe.res;
+                c.error_code        = -res;
             }
             head++;
         }
 
-        if (count > 0)
+        if (head != *ring->cqhead)
             store_release(ring->cqhead, head);
 
         // If the CQ overflowed, poke the kernel to flush the overflow list.
         // We don't grab the new entries here — they'll appear in the next poll/wait.
         if (load_acquire(ring->sqflags) & BEE__IORING_SQ_CQ_OVERFLOW) {
-            int rc;
-            do {
-                rc = sys_io_uring_enter(ring->ringfd, 0, 0, BEE__IORING_ENTER_GETEVENTS, nullptr);
-            } while (rc == -1 && errno == EINTR);
+            ring->stats.cq_overflows++;
+            uring_enter(ring, 0, 0, BEE__IORING_ENTER_GETEVENTS);
         }
 
         return static_cast<int>(count);
@@ -425,11 +1388,22 @@ namespace bee::async {
 
     // ---- async_uring public interface ----
 
-    async_uring::async_uring()
-        : m_ring(new io_uring {}) {
-        if (!uring_init(kEntries, m_ring)) {
+    async_uring::async_uring(const async_options& options)
+        : m_ring(new io_uring {})
+        , m_post_ring(nullptr)
+        , m_post_target(-1)
+        , m_busy(static_cast<int64_t>(options.busy_poll) * 1000) {
+        if (!uring_init(options, m_ring)) {
             delete m_ring;
             m_ring = nullptr;
+            return;
+        }
+        m_post_target = m_ring->ringfd;
+        // Without MSG_RING (before 5.18) post goes through an eventfd.
+        m_ring->msg_ring = uring_probe_op(m_ring, BEE__IORING_OP_MSG_RING);
+        if (!m_ring->msg_ring) {
+            m_ring->post_efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            uring_post_arm(m_ring);
         }
     }
 
@@ -437,64 +1411,91 @@ namespace bee::async {
         stop();
     }
 
-    bool async_uring::submit_read(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id) {
+    bool async_uring::submit_read(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id, int timeout) {
         if (!m_ring) return false;
-        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring, timeout >= 0 ? 2 : 1);
         if (!sqe) return false;
-        auto ctx       = std::make_unique<iov_ctx>(bufs);
+        uint32_t slot = uring_op_alloc(m_ring, request_id, async_op::read);
+        uring_op& ctx = m_ring->ops[slot];
+        uring_op_set_iov(ctx, bufs);
         sqe->opcode    = BEE__IORING_OP_RECVMSG;
-        sqe->fd        = fd;
-        sqe->addr      = reinterpret_cast<uintptr_t>(&ctx->msg);
+        sqe->addr      = reinterpret_cast<uintptr_t>(&ctx.msg);
         sqe->len       = 1;
         sqe->msg_flags = 0;
-        sqe->user_data = pack_user_data(async_op::read, request_id);
-        m_ring->io_pending.emplace(request_id, std::move(ctx));
-        uring_submit(m_ring);
+        sqe->user_data = pack_user_data(async_op::read, slot);
+        uring_op_set_fd(m_ring, sqe, slot, fd);
+        uring_submit_deadline(m_ring, sqe, slot, async_op::read, timeout);
         return true;
     }
 
-    bool async_uring::submit_write(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id) {
+    bool async_uring::submit_write(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id, int timeout) {
         if (!m_ring) return false;
-        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring, timeout >= 0 ? 2 : 1);
         if (!sqe) return false;
-        auto ctx       = std::make_unique<iov_ctx>(bufs);
-        sqe->opcode    = BEE__IORING_OP_SENDMSG;
-        sqe->fd        = fd;
-        sqe->addr      = reinterpret_cast<uintptr_t>(&ctx->msg);
+        uint32_t slot = uring_op_alloc(m_ring, request_id, async_op::write);
+        uring_op& ctx = m_ring->ops[slot];
+        uring_op_set_iov(ctx, bufs);
+        // A deadline already holds the op until a second CQE; zero-copy is
+        // kept to writes without one.
+        if (m_ring->zc_threshold != 0 && timeout < 0) {
+            size_t total = 0;
+            for (auto& b : bufs) total += b.iov_len;
+            if (total >= m_ring->zc_threshold) ctx.zc = true;
+        }
+        sqe->opcode    = ctx.zc ? BEE__IORING_OP_SENDMSG_ZC : BEE__IORING_OP_SENDMSG;
+        sqe->addr      = reinterpret_cast<uintptr_t>(&ctx.msg);
         sqe->len       = 1;
         sqe->msg_flags = 0;
-        sqe->user_data = pack_user_data(async_op::write, request_id);
-        m_ring->io_pending.emplace(request_id, std::move(ctx));
-        uring_submit(m_ring);
+        sqe->user_data = pack_user_data(async_op::write, slot);
+        uring_op_set_fd(m_ring, sqe, slot, fd);
+        uring_submit_deadline(m_ring, sqe, slot, async_op::write, timeout);
         return true;
     }
 
-    bool async_uring::submit_accept(net::fd_t listen_fd, uint64_t request_id) {
+    bool async_uring::submit_accept(net::fd_t listen_fd, uint64_t request_id, int timeout) {
         if (!m_ring) return false;
-        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring, timeout >= 0 ? 2 : 1);
         if (!sqe) return false;
+        uint32_t slot     = uring_op_alloc(m_ring, request_id, async_op::accept);
         sqe->opcode       = BEE__IORING_OP_ACCEPT;
-        sqe->fd           = listen_fd;
         sqe->addr         = 0;  // don't capture peer address
         sqe->addr2        = 0;  // no socklen_t output
         sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
-        sqe->user_data    = pack_user_data(async_op::accept, request_id);
-        uring_submit(m_ring);
+        sqe->user_data    = pack_user_data(async_op::accept, slot);
+        uring_op_set_fd(m_ring, sqe, slot, listen_fd);
+        uring_submit_deadline(m_ring, sqe, slot, async_op::accept, timeout);
         return true;  // SQE queued; will be submitted on next poll/wait
     }
 
-    bool async_uring::submit_connect(net::fd_t fd, const net::endpoint& ep, uint64_t request_id) {
+    bool async_uring::submit_accept_multishot(net::fd_t listen_fd, uint64_t request_id) {
         if (!m_ring) return false;
         bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
         if (!sqe) return false;
+        uint32_t slot = uring_op_alloc(m_ring, request_id, async_op::accept);
+        // One SQE keeps posting a CQE (with IORING_CQE_F_MORE) per accepted
+        // connection until it fails or is cancelled.
+        sqe->opcode       = BEE__IORING_OP_ACCEPT;
+        sqe->ioprio       = BEE__IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+        sqe->user_data    = pack_user_data(async_op::accept, slot);
+        uring_op_set_fd(m_ring, sqe, slot, listen_fd);
+        uring_submit(m_ring);
+        return true;
+    }
+
+    bool async_uring::submit_connect(net::fd_t fd, const net::endpoint& ep, uint64_t request_id, int timeout) {
+        if (!m_ring) return false;
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring, timeout >= 0 ? 2 : 1);
+        if (!sqe) return false;
         // The caller (Lua binding) pins the endpoint in the buf table, guaranteeing
         // ep.addr() remains valid until the CQE is harvested.
+        uint32_t slot  = uring_op_alloc(m_ring, request_id, async_op::connect);
         sqe->opcode    = BEE__IORING_OP_CONNECT;
-        sqe->fd        = fd;
         sqe->addr      = reinterpret_cast<uintptr_t>(ep.addr());
         sqe->off       = ep.addrlen();  // CONNECT stores addrlen in the off field
-        sqe->user_data = pack_user_data(async_op::connect, request_id);
-        uring_submit(m_ring);
+        sqe->user_data = pack_user_data(async_op::connect, slot);
+        uring_op_set_fd(m_ring, sqe, slot, fd);
+        uring_submit_deadline(m_ring, sqe, slot, async_op::connect, timeout);
         return true;  // SQE queued; will be submitted on next poll/wait
     }
 
@@ -502,12 +1503,13 @@ namespace bee::async {
         if (!m_ring) return false;
         bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
         if (!sqe) return false;
+        uint32_t slot = uring_op_alloc(m_ring, request_id, async_op::file_read);
         sqe->opcode    = BEE__IORING_OP_READ;
-        sqe->fd        = fd;
         sqe->addr      = reinterpret_cast<uintptr_t>(buffer);
         sqe->len       = static_cast<uint32_t>(len);
         sqe->off       = static_cast<uint64_t>(offset);
-        sqe->user_data = pack_user_data(async_op::file_read, request_id);
+        sqe->user_data = pack_user_data(async_op::file_read, slot);
+        uring_op_set_fd(m_ring, sqe, slot, fd);
         uring_submit(m_ring);
         return true;  // SQE queued; will be submitted on next poll/wait
     }
@@ -516,60 +1518,347 @@ namespace bee::async {
         if (!m_ring) return false;
         bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
         if (!sqe) return false;
+        uint32_t slot = uring_op_alloc(m_ring, request_id, async_op::file_write);
         sqe->opcode    = BEE__IORING_OP_WRITE;
-        sqe->fd        = fd;
         sqe->addr      = reinterpret_cast<uintptr_t>(buffer);
         sqe->len       = static_cast<uint32_t>(len);
         sqe->off       = static_cast<uint64_t>(offset);
-        sqe->user_data = pack_user_data(async_op::file_write, request_id);
+        sqe->user_data = pack_user_data(async_op::file_write, slot);
+        uring_op_set_fd(m_ring, sqe, slot, fd);
         uring_submit(m_ring);
         return true;  // SQE queued; will be submitted on next poll/wait
     }
 
+    bool async_uring::submit_file_open(const char* path, int flags, int mode, uint64_t request_id) {
+        if (!m_ring) return false;
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
+        if (!sqe) return false;
+        // The kernel copies path when the SQE is consumed, not when it is
+        // queued; the caller keeps it alive until the completion.
+        sqe->opcode     = BEE__IORING_OP_OPENAT;
+        sqe->fd         = AT_FDCWD;
+        sqe->addr       = reinterpret_cast<uintptr_t>(path);
+        sqe->len        = static_cast<uint32_t>(mode);
+        sqe->open_flags = static_cast<uint32_t>(flags);
+        sqe->user_data  = pack_user_data(async_op::file_open, uring_op_alloc(m_ring, request_id, async_op::file_open));
+        uring_submit(m_ring);
+        return true;
+    }
+
+    bool async_uring::submit_file_close(file_handle::value_type fd, uint64_t request_id) {
+        if (!m_ring) return false;
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
+        if (!sqe) return false;
+        // IORING_OP_CLOSE takes the plain fd; drop a fixed table entry first
+        // so the table does not keep the file open.
+        uring_unregister_fd(m_ring, fd);
+        sqe->opcode    = BEE__IORING_OP_CLOSE;
+        sqe->fd        = fd;
+        sqe->user_data = pack_user_data(async_op::file_close, uring_op_alloc(m_ring, request_id, async_op::file_close));
+        uring_submit(m_ring);
+        return true;
+    }
+
+    bool async_uring::submit_fsync(file_handle::value_type fd, bool datasync, uint64_t request_id) {
+        if (!m_ring) return false;
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
+        if (!sqe) return false;
+        uint32_t slot = uring_op_alloc(m_ring, request_id, async_op::file_fsync);
+        sqe->opcode      = BEE__IORING_OP_FSYNC;
+        sqe->fsync_flags = datasync ? BEE__IORING_FSYNC_DATASYNC : 0;
+        sqe->user_data   = pack_user_data(async_op::file_fsync, slot);
+        uring_op_set_fd(m_ring, sqe, slot, fd);
+        uring_submit(m_ring);
+        return true;
+    }
+
+    bool async_uring::submit_statx(file_handle::value_type dirfd, const char* path, void* statxbuf, uint64_t request_id) {
+        if (!m_ring) return false;
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
+        if (!sqe) return false;
+        sqe->opcode      = BEE__IORING_OP_STATX;
+        sqe->fd          = dirfd;
+        sqe->addr        = reinterpret_cast<uintptr_t>(path);
+        sqe->addr2       = reinterpret_cast<uintptr_t>(statxbuf);
+        sqe->len         = statx_basic_stats;
+        sqe->statx_flags = path[0] == '\0' ? AT_EMPTY_PATH : 0;
+        sqe->user_data   = pack_user_data(async_op::file_statx, uring_op_alloc(m_ring, request_id, async_op::file_statx));
+        uring_submit(m_ring);
+        return true;
+    }
+
+    bool async_uring::submit_sendfile(net::fd_t fd, file_handle::value_type file, int64_t offset, uint64_t len, uint64_t request_id) {
+        if (!m_ring || len == 0) return false;
+        uint32_t slot = uring_op_alloc(m_ring, request_id, async_op::sendfile);
+        auto& sp      = m_ring->ops[slot].sp;
+        sp.src        = file;
+        sp.dst        = fd;
+        sp.src_off    = offset;
+        sp.remaining  = len;
+        return uring_splice_start(m_ring, slot, async_op::sendfile);
+    }
+
+    bool async_uring::submit_relay(net::fd_t src, net::fd_t dst, uint64_t limit, uint64_t request_id) {
+        if (!m_ring) return false;
+        uint32_t slot = uring_op_alloc(m_ring, request_id, async_op::relay);
+        auto& sp      = m_ring->ops[slot].sp;
+        sp.src        = src;
+        sp.dst        = dst;
+        sp.src_off    = -1;
+        sp.remaining  = limit ? limit : UINT64_MAX;
+        return uring_splice_start(m_ring, slot, async_op::relay);
+    }
+
+    // One datagram per RECVMSG/SENDMSG; msg_name points straight at ep.
+    bool async_uring::submit_recvfrom(net::fd_t fd, void* buffer, size_t len, net::endpoint* ep, uint64_t request_id) {
+        if (!m_ring) return false;
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
+        if (!sqe) return false;
+        uint32_t slot = uring_op_alloc(m_ring, request_id, async_op::recvfrom);
+        uring_op& ctx = m_ring->ops[slot];
+        net::socket::iobuf buf;
+        buf.set(static_cast<const char*>(buffer), len);
+        uring_op_set_iov(ctx, span<const net::socket::iobuf>(&buf, 1));
+        ctx.ep                 = ep;
+        ctx.msg.msg_name       = ep->out_addr();
+        ctx.msg.msg_namelen    = *ep->out_addrlen();
+        ctx.msg.msg_control    = ctx.cmsg;
+        ctx.msg.msg_controllen = sizeof(ctx.cmsg);
+        sqe->opcode         = BEE__IORING_OP_RECVMSG;
+        sqe->addr           = reinterpret_cast<uintptr_t>(&ctx.msg);
+        sqe->len            = 1;
+        sqe->user_data      = pack_user_data(async_op::recvfrom, slot);
+        uring_op_set_fd(m_ring, sqe, slot, fd);
+        uring_submit(m_ring);
+        return true;
+    }
+
+    bool async_uring::submit_sendto(net::fd_t fd, const void* buffer, size_t len, const net::endpoint* ep, int gso, uint64_t request_id) {
+        if (!m_ring) return false;
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
+        if (!sqe) return false;
+        uint32_t slot = uring_op_alloc(m_ring, request_id, async_op::sendto);
+        uring_op& ctx = m_ring->ops[slot];
+        net::socket::iobuf buf;
+        buf.set(static_cast<const char*>(buffer), len);
+        uring_op_set_iov(ctx, span<const net::socket::iobuf>(&buf, 1));
+        if (ep) {
+            ctx.msg.msg_name    = const_cast<sockaddr*>(ep->addr());
+            ctx.msg.msg_namelen = ep->addrlen();
+        }
+        if (gso > 0) {
+            ctx.msg.msg_control    = ctx.cmsg;
+            ctx.msg.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+            struct cmsghdr* c      = CMSG_FIRSTHDR(&ctx.msg);
+            c->cmsg_level          = IPPROTO_UDP;
+            c->cmsg_type           = UDP_SEGMENT;
+            c->cmsg_len            = CMSG_LEN(sizeof(uint16_t));
+            const uint16_t v       = static_cast<uint16_t>(gso);
+            memcpy(CMSG_DATA(c), &v, sizeof(v));
+        }
+        sqe->opcode    = BEE__IORING_OP_SENDMSG;
+        sqe->addr      = reinterpret_cast<uintptr_t>(&ctx.msg);
+        sqe->len       = 1;
+        sqe->msg_flags = MSG_NOSIGNAL;
+        sqe->user_data = pack_user_data(async_op::sendto, slot);
+        uring_op_set_fd(m_ring, sqe, slot, fd);
+        uring_submit(m_ring);
+        return true;
+    }
+
     bool async_uring::submit_poll(net::fd_t fd, uint64_t request_id) {
         if (!m_ring) return false;
         bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
         if (!sqe) return false;
+        uint32_t slot = uring_op_alloc(m_ring, request_id, async_op::fd_poll);
         sqe->opcode    = BEE__IORING_OP_POLL_ADD;
-        sqe->fd        = fd;
         sqe->rw_flags  = POLLIN;  // 监听可读事件
-        sqe->user_data = pack_user_data(async_op::fd_poll, request_id);
+        sqe->user_data = pack_user_data(async_op::fd_poll, slot);
+        uring_op_set_fd(m_ring, sqe, slot, fd);
+        uring_submit(m_ring);
+        return true;
+    }
+
+    bool async_uring::submit_recv(net::fd_t fd, uint16_t group, uint64_t request_id) {
+        if (!m_ring) return false;
+        if (group >= m_ring->buf_rings.size()) return false;
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
+        if (!sqe) return false;
+        uint32_t slot           = uring_op_alloc(m_ring, request_id, async_op::recv);
+        m_ring->ops[slot].group = group;
+        // No buffer is attached: the kernel picks one from the group's ring
+        // only once data arrives (-ENOBUFS if the ring is empty).
+        sqe->opcode    = BEE__IORING_OP_RECV;
+        sqe->flags     = BEE__IOSQE_BUFFER_SELECT;
+        sqe->len       = static_cast<uint32_t>(m_ring->buf_rings[group]->pool.buf_size());
+        sqe->buf_group = group;
+        sqe->user_data = pack_user_data(async_op::recv, slot);
+        uring_op_set_fd(m_ring, sqe, slot, fd);
+        uring_submit(m_ring);
+        return true;
+    }
+
+    bool async_uring::submit_recv_multishot(net::fd_t fd, uint16_t group, uint64_t request_id) {
+        if (!m_ring) return false;
+        if (group >= m_ring->buf_rings.size()) return false;
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
+        if (!sqe) return false;
+        uint32_t slot           = uring_op_alloc(m_ring, request_id, async_op::recv);
+        m_ring->ops[slot].group = group;
+        // Stays armed and posts one CQE (IORING_CQE_F_MORE) per received chunk
+        // until EOF, an error, an empty buffer ring (-ENOBUFS) or cancel.
+        sqe->opcode    = BEE__IORING_OP_RECV;
+        sqe->flags     = BEE__IOSQE_BUFFER_SELECT;
+        sqe->ioprio    = BEE__IORING_RECV_MULTISHOT;
+        sqe->len       = 0;  // multishot recv always uses the full buffer length
+        sqe->buf_group = group;
+        sqe->user_data = pack_user_data(async_op::recv, slot);
+        uring_op_set_fd(m_ring, sqe, slot, fd);
+        uring_submit(m_ring);
+        return true;
+    }
+
+    bool async_uring::submit_timer(int timeout, uint64_t timer_id, uint64_t request_id) {
+        if (!m_ring) return false;
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
+        if (!sqe) return false;
+        uint32_t slot  = uring_op_alloc(m_ring, request_id, async_op::timer);
+        uring_op& ctx  = m_ring->ops[slot];
+        ctx.ts.tv_sec  = timeout / 1000;
+        ctx.ts.tv_nsec = static_cast<int64_t>(timeout % 1000) * 1000000L;
+        ctx.timer_id   = timer_id;
+        sqe->opcode    = BEE__IORING_OP_TIMEOUT;
+        sqe->fd        = -1;
+        sqe->addr      = reinterpret_cast<uintptr_t>(&ctx.ts);
+        sqe->len       = 1;
+        sqe->off       = 0;  // pure timer: not satisfied by other completions
+        sqe->user_data = pack_user_data(async_op::timer, slot);
+        m_ring->timers[timer_id] = slot;
         uring_submit(m_ring);
         return true;
     }
 
+    int async_uring::create_buffer_pool(size_t buf_size, uint16_t count) {
+        if (!m_ring) {
+            errno = EBADF;
+            return -1;
+        }
+        if (count == 0 || count > 32768 || buf_size == 0 || buf_size > UINT32_MAX) {
+            errno = EINVAL;
+            return -1;
+        }
+        size_t group = m_ring->buf_rings.size();
+        if (group > UINT16_MAX) {
+            errno = ENOSPC;
+            return -1;
+        }
+        if (!buffer_pool::fits(buf_size, count)) {
+            errno = ENOMEM;
+            return -1;
+        }
+
+        uint16_t entries = 1;
+        while (entries < count) entries <<= 1;
+
+        auto br = std::make_unique<pbuf_ring>(buf_size, count);
+        if (!br->pool.ok()) {
+            errno = ENOMEM;
+            return -1;
+        }
+        br->ringlen = entries * sizeof(bee__io_uring_buf);
+        void* mem   = mmap(nullptr, br->ringlen, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        if (mem == MAP_FAILED) return -1;
+        br->bufs = static_cast<bee__io_uring_buf*>(mem);
+        br->mask = static_cast<uint16_t>(entries - 1);
+
+        bee__io_uring_buf_reg reg;
+        memset(&reg, 0, sizeof(reg));
+        reg.ring_addr    = reinterpret_cast<uintptr_t>(br->bufs);
+        reg.ring_entries = entries;
+        reg.bgid         = static_cast<uint16_t>(group);
+        if (sys_io_uring_register(m_ring->ringfd, BEE__IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+            int ec = errno;
+            munmap(br->bufs, br->ringlen);
+            errno = ec;
+            return -1;
+        }
+        for (uint16_t bid = 0; bid < count; ++bid) {
+            pbuf_ring_add(br.get(), bid);
+        }
+        pbuf_ring_publish(br.get());
+        m_ring->buf_rings.emplace_back(std::move(br));
+        return static_cast<int>(group);
+    }
+
+    buffer_pool* async_uring::get_buffer_pool(uint16_t group) {
+        if (!m_ring || group >= m_ring->buf_rings.size()) return nullptr;
+        return &m_ring->buf_rings[group]->pool;
+    }
+
+    bool async_uring::recycle_buffer(uint16_t group, uint16_t bid) {
+        if (!m_ring || group >= m_ring->buf_rings.size()) return false;
+        pbuf_ring* br = m_ring->buf_rings[group].get();
+        // Only a buffer the kernel handed out may go back on the ring; a
+        // second entry for the same bid would let two receives share it.
+        if (!br->pool.valid(bid) || !br->pool.give_back(bid)) return false;
+        pbuf_ring_add(br, bid);
+        pbuf_ring_publish(br);
+        return true;
+    }
+
+    bool async_uring::register_fd(int fd) {
+        if (!m_ring) return false;
+        return uring_register_fd(m_ring, fd);
+    }
+
+    void async_uring::unregister_fd(int fd) {
+        if (!m_ring) return;
+        uring_unregister_fd(m_ring, fd);
+    }
+
     int async_uring::poll(const span<io_completion>& completions) {
         if (!m_ring) return 0;
-        return wait(completions, 0);
+        return wait_block(completions, 0);
     }
 
     int async_uring::wait(const span<io_completion>& completions, int timeout) {
+        return wait_ns(completions, timeout < 0 ? -1 : static_cast<int64_t>(timeout) * 1000000);
+    }
+
+    int async_uring::wait_ns(const span<io_completion>& completions, int64_t timeout_ns) {
         if (!m_ring) return 0;
+        return m_busy.wait(
+            timeout_ns,
+            [&] { return wait_block(completions, 0); },
+            [&](int64_t rest) { return wait_block(completions, rest); }
+        );
+    }
+
+    int async_uring::wait_block(const span<io_completion>& completions, int64_t timeout_ns) {
+        // Values collected from the post stack are already waiting.
+        if (!m_ring->posted.empty()) timeout_ns = 0;
+        uring_post_arm(m_ring);
+
         // Submit any pending SQEs and wait for at least one CQE in a single syscall.
         uint32_t pending = uring_pending(m_ring);
 
-        if (timeout == 0) {
+        if (timeout_ns == 0) {
             // Non-blocking: flush pending SQEs then harvest whatever is already done.
-            if (pending > 0) {
-                int ret;
-                do {
-                    ret = sys_io_uring_enter(m_ring->ringfd, pending, 0, 0, nullptr);
-                } while (ret == -1 && errno == EINTR);
+            uint32_t flags = uring_needs_getevents(m_ring) ? BEE__IORING_ENTER_GETEVENTS : 0;
+            if (pending > 0 || flags != 0) {
+                uring_enter(m_ring, pending, 0, flags);
             }
             return harvest_cqes(completions);
-        } else if (timeout > 0) {
+        } else if (timeout_ns > 0) {
             if (m_ring->ext_arg_supported) {
                 // Fast path (kernel 5.11+): pass timeout directly to io_uring_enter.
                 bee__kernel_timespec ts;
-                ts.tv_sec  = timeout / 1000;
-                ts.tv_nsec = static_cast<int64_t>(timeout % 1000) * 1000000L;
+                ts.tv_sec  = timeout_ns / 1000000000;
+                ts.tv_nsec = timeout_ns % 1000000000;
                 bee__io_uring_getevents_arg arg;
                 memset(&arg, 0, sizeof(arg));
                 arg.ts = reinterpret_cast<uintptr_t>(&ts);
-                int ret;
-                do {
-                    ret = sys_io_uring_enter(m_ring->ringfd, pending, 1, BEE__IORING_ENTER_GETEVENTS | BEE__IORING_ENTER_EXT_ARG, &arg);
-                } while (ret == -1 && errno == EINTR);
+                int ret = uring_enter(m_ring, pending, 1, BEE__IORING_ENTER_GETEVENTS | BEE__IORING_ENTER_EXT_ARG, &arg);
                 if (ret == -1 && errno == EINVAL) {
                     // Kernel does not support EXT_ARG; disable and fall through to TIMEOUT SQE path.
                     m_ring->ext_arg_supported = false;
@@ -584,8 +1873,8 @@ namespace bee::async {
                 bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
                 if (sqe) {
                     bee__kernel_timespec ts;
-                    ts.tv_sec  = timeout / 1000;
-                    ts.tv_nsec = static_cast<int64_t>(timeout % 1000) * 1000000L;
+                    ts.tv_sec  = timeout_ns / 1000000000;
+                    ts.tv_nsec = timeout_ns % 1000000000;
                     memset(sqe, 0, sizeof(*sqe));
                     sqe->opcode    = BEE__IORING_OP_TIMEOUT;
                     sqe->addr      = reinterpret_cast<uintptr_t>(&ts);
@@ -594,34 +1883,190 @@ namespace bee::async {
                     uring_submit(m_ring);
                     pending = uring_pending(m_ring);
                 }
-                int ret;
-                do {
-                    ret = sys_io_uring_enter(m_ring->ringfd, pending, 1, BEE__IORING_ENTER_GETEVENTS, nullptr);
-                } while (ret == -1 && errno == EINTR);
+                uring_enter(m_ring, pending, 1, BEE__IORING_ENTER_GETEVENTS);
             }
         } else {
             // Block until at least one CQE is available, submitting pending SQEs atomically.
-            int ret;
-            do {
-                ret = sys_io_uring_enter(m_ring->ringfd, pending, 1, BEE__IORING_ENTER_GETEVENTS, nullptr);
-            } while (ret == -1 && errno == EINTR);
+            uring_enter(m_ring, pending, 1, BEE__IORING_ENTER_GETEVENTS);
         }
 
         return harvest_cqes(completions);
     }
 
+    // ---- cross-thread post ----
+    //
+    // Other threads share a small private ring, created on the first post,
+    // and send each value to m_ring with IORING_OP_MSG_RING: the kernel
+    // posts it straight into m_ring's CQ, which also wakes a blocked wait.
+    // The sending CQE is reaped before returning so errors reach the caller.
+    // Kernels without MSG_RING use the epoll backend's scheme instead: a
+    // lock-free stack and an eventfd rung when it stops being empty.
+
+    bool async_uring::post(uint64_t request_id) {
+        if (request_id > kPostMask) {
+            errno = EINVAL;
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_post_mutex);
+        if (m_post_target < 0) {
+            errno = EBADF;
+            return false;
+        }
+        if (!m_ring->msg_ring) {
+            if (m_ring->post_efd < 0) {
+                errno = ENOSYS;
+                return false;
+            }
+            auto* node                = new io_uring::post_node { nullptr, request_id };
+            io_uring::post_node* head = m_ring->posts.load(std::memory_order_relaxed);
+            do {
+                node->next = head;
+            } while (!m_ring->posts.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+            if (head == nullptr) {
+                uint64_t one               = 1;
+                [[maybe_unused]] ssize_t r = write(m_ring->post_efd, &one, sizeof(one));
+            }
+            return true;
+        }
+        if (!m_post_ring) {
+            async_options options;
+            options.entries = 2;
+            auto* ring      = new io_uring {};
+            if (!uring_init(options, ring)) {
+                delete ring;
+                return false;
+            }
+            m_post_ring = ring;
+        }
+        io_uring* ring         = m_post_ring;
+        bee__io_uring_sqe* sqe = uring_get_sqe(ring);
+        if (!sqe) {
+            errno = EBUSY;
+            return false;
+        }
+        sqe->opcode = BEE__IORING_OP_MSG_RING;
+        sqe->fd     = m_post_target;
+        sqe->off    = pack_user_data(async_op::post, 0) | request_id;
+        uring_submit(ring);
+        if (uring_enter(ring, 1, 1, BEE__IORING_ENTER_GETEVENTS) < 0) {
+            return false;
+        }
+        uint32_t head = *ring->cqhead;
+        if (head == load_acquire(ring->cqtail)) {
+            errno = EAGAIN;
+            return false;
+        }
+        int32_t res = ring->cqes[head & ring->cqmask].res;
+        store_release(ring->cqhead, head + 1);
+        if (res < 0) {
+            errno = -res;
+            return false;
+        }
+        return true;
+    }
+
+    void async_uring::stats(async_stats& out) {
+        if (!m_ring) {
+            out = {};
+            return;
+        }
+        out           = m_ring->stats;
+        out.inflight  = m_ring->ops.in_use();
+        out.spin_ns   = m_busy.spin_ns;
+        out.block_ns  = m_busy.block_ns;
+        out.spin_hits = m_busy.spin_hits;
+    }
+
+    // Before the ring goes away: run the closes still queued in the SQ, since
+    // the caller already gave up those fds, and close the fds of opens that
+    // completed but were never harvested.  Under SQPOLL the kernel thread
+    // submits the queued SQEs itself.
+    static void uring_stop_files(io_uring* ring) noexcept {
+        if (!(ring->setup_flags & BEE__IORING_SETUP_SQPOLL)) {
+            uint32_t tail = *ring->sqtail;
+            for (uint32_t head = load_acquire(ring->sqhead); head != tail; ++head) {
+                const bee__io_uring_sqe& sqe = ring->sqe[head & ring->sqmask];
+                if (sqe.opcode == BEE__IORING_OP_CLOSE) {
+                    close(sqe.fd);
+                }
+            }
+        }
+        uint32_t tail = load_acquire(ring->cqtail);
+        for (uint32_t head = *ring->cqhead; head != tail; ++head) {
+            const bee__io_uring_cqe& cqe = ring->cqes[head & ring->cqmask];
+            if (unpack_op(cqe.user_data) == async_op::file_open && cqe.res >= 0) {
+                close(cqe.res);
+            }
+        }
+    }
+
     void async_uring::stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_post_mutex);
+            m_post_target = -1;
+            if (m_post_ring) {
+                uring_exit(m_post_ring);
+                delete m_post_ring;
+                m_post_ring = nullptr;
+            }
+        }
         if (m_ring) {
+            uring_stop_files(m_ring);
             uring_exit(m_ring);
             delete m_ring;
             m_ring = nullptr;
         }
     }
 
-    void async_uring::cancel(net::fd_t /*fd*/) {
-        // 这是一个空操作。对于 io_uring，这个调用不会取消挂起的操作。
-        // 当文件描述符关闭时，这些操作将被内核取消，并最终以 ECANCELED 错误完成。
-        // 要实现立即取消，需要使用 IORING_OP_ASYNC_CANCEL。
+    // Cancel every live request on fd (of kind op unless any) by its
+    // user_data, which every kernel since 5.5 understands; matching by
+    // IORING_ASYNC_CANCEL_FD/ALL needs 5.19 and _OP 6.6, and the error from
+    // an older kernel would be lost in the swallowed cancel CQE.  Each
+    // matching request completes with -ECANCELED (async_status::cancel).
+    // fd_ops holds the requests on fd, so shedding many connections stays
+    // linear.  Splice transfers keep fd == -1 and are cancelled by
+    // uring_cancel_splices instead.
+    static void uring_cancel_ops(io_uring* ring, net::fd_t fd, bool any, async_op op) {
+        size_t idx = static_cast<size_t>(fd);
+        if (fd < 0 || idx >= ring->fd_ops.size()) return;
+        for (uint32_t slot : ring->fd_ops[idx]) {
+            const uring_op& ctx = ring->ops[slot];
+            if (!any && ctx.op != op) continue;
+            ring->cancel_targets.push_back(pack_user_data(ctx.op, slot));
+        }
+        uring_submit_cancels(ring);
+    }
+
+    void async_uring::cancel_timer(uint64_t timer_id) {
+        if (!m_ring) return;
+        auto it = m_ring->timers.find(timer_id);
+        if (it == m_ring->timers.end()) return;
+        bee__io_uring_sqe* sqe = uring_get_sqe(m_ring);
+        if (!sqe) return;
+        // The timer completes with -ECANCELED; if it already fired the
+        // remove fails with -ENOENT and the expiry is delivered instead.
+        sqe->opcode    = BEE__IORING_OP_TIMEOUT_REMOVE;
+        sqe->fd        = -1;
+        sqe->addr      = pack_user_data(async_op::timer, it->second);
+        sqe->user_data = pack_user_data(async_op::cancel, 0);
+        uring_submit(m_ring);
+        m_ring->timers.erase(it);
+    }
+
+    void async_uring::cancel(net::fd_t fd) {
+        if (!m_ring) return;
+        uring_cancel_ops(m_ring, fd, true, async_op::read);
+        uring_cancel_splices(m_ring, fd, async_op::sendfile);
+        uring_cancel_splices(m_ring, fd, async_op::relay);
+    }
+
+    void async_uring::cancel(net::fd_t fd, async_op op) {
+        if (!m_ring) return;
+        if (op == async_op::sendfile || op == async_op::relay) {
+            uring_cancel_splices(m_ring, fd, op);
+            return;
+        }
+        uring_cancel_ops(m_ring, fd, false, op);
     }
 
 }  // namespace bee::async
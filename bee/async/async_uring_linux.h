@@ -3,10 +3,12 @@
 #include <bee/async/async.h>
 #include <bee/net/fd.h>
 #include <bee/sys/file_handle.h>
+#include <bee/utility/busy_poll.h>
 #include <bee/utility/span.h>
 
 #include <cstddef>
 #include <cstdint>
+#include <mutex>
 
 // io_uring is defined internally in the .cpp; forward-declare the ring type here.
 struct io_uring;
@@ -15,27 +17,60 @@ namespace bee::async {
 
     class async_uring : public async {
     public:
-        async_uring();
+        explicit async_uring(const async_options& options = {});
         ~async_uring() override;
 
-        bool submit_read(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id) override;
-        bool submit_write(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id) override;
-        bool submit_accept(net::fd_t listen_fd, uint64_t request_id) override;
-        bool submit_connect(net::fd_t fd, const net::endpoint& ep, uint64_t request_id) override;
+        bool submit_read(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id, int timeout = -1) override;
+        bool submit_write(net::fd_t fd, span<const net::socket::iobuf> bufs, uint64_t request_id, int timeout = -1) override;
+        bool submit_accept(net::fd_t listen_fd, uint64_t request_id, int timeout = -1) override;
+        bool submit_accept_multishot(net::fd_t listen_fd, uint64_t request_id) override;
+        bool submit_connect(net::fd_t fd, const net::endpoint& ep, uint64_t request_id, int timeout = -1) override;
         bool submit_file_read(file_handle::value_type fd, void* buffer, size_t len, int64_t offset, uint64_t request_id) override;
         bool submit_file_write(file_handle::value_type fd, const void* buffer, size_t len, int64_t offset, uint64_t request_id) override;
+        bool submit_file_open(const char* path, int flags, int mode, uint64_t request_id) override;
+        bool submit_file_close(file_handle::value_type fd, uint64_t request_id) override;
+        bool submit_fsync(file_handle::value_type fd, bool datasync, uint64_t request_id) override;
+        bool submit_statx(file_handle::value_type dirfd, const char* path, void* statxbuf, uint64_t request_id) override;
+        bool submit_sendfile(net::fd_t fd, file_handle::value_type file, int64_t offset, uint64_t len, uint64_t request_id) override;
+        bool submit_relay(net::fd_t src, net::fd_t dst, uint64_t limit, uint64_t request_id) override;
+        bool submit_recvfrom(net::fd_t fd, void* buffer, size_t len, net::endpoint* ep, uint64_t request_id) override;
+        bool submit_sendto(net::fd_t fd, const void* buffer, size_t len, const net::endpoint* ep, int gso, uint64_t request_id) override;
         bool submit_poll(net::fd_t fd, uint64_t request_id) override;
+        bool submit_recv(net::fd_t fd, uint16_t group, uint64_t request_id) override;
+        bool submit_recv_multishot(net::fd_t fd, uint16_t group, uint64_t request_id) override;
+        bool submit_timer(int timeout, uint64_t timer_id, uint64_t request_id) override;
+        bool post(uint64_t request_id) override;
+        void stats(async_stats& out) override;
+        int create_buffer_pool(size_t buf_size, uint16_t count) override;
+        buffer_pool* get_buffer_pool(uint16_t group) override;
+        bool recycle_buffer(uint16_t group, uint16_t bid) override;
+        bool register_fd(int fd) override;
+        void unregister_fd(int fd) override;
         int poll(const span<io_completion>& completions) override;
         int wait(const span<io_completion>& completions, int timeout) override;
+        int wait_ns(const span<io_completion>& completions, int64_t timeout_ns) override;
         void stop() override;
         void cancel(net::fd_t fd) override;
+        void cancel(net::fd_t fd, async_op op) override;
+        void cancel_timer(uint64_t timer_id) override;
 
         bool valid() const noexcept { return m_ring != nullptr; }
 
     private:
         io_uring* m_ring;  // nullptr if ring initialisation failed
 
+        // post: sending ring shared by other threads, and m_ring's fd
+        // (-1 once stopped); both guarded by m_post_mutex.
+        io_uring* m_post_ring;
+        int m_post_target;
+        std::mutex m_post_mutex;
+
+        busy_poll m_busy;  // spin window in front of a blocking wait
+
         int harvest_cqes(const span<io_completion>& completions) noexcept;
+
+        // wait_ns without the busy-poll window.
+        int wait_block(const span<io_completion>& completions, int64_t timeout_ns);
     };
 
 }  // namespace bee::async
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace bee::async {
+
+    // Fixed set of equally sized receive buffers shared by all streams of one
+    // async instance (buffer-select mode).
+    //
+    // Buffers are addressed by a 16-bit buffer id (bid).  A backend hands a
+    // buffer to a receive only when data actually arrives; the completion
+    // carries the bid and the caller gives it back with recycle once the data
+    // has been consumed.  Each bid remembers whether it is out, so recycling
+    // one twice (or one never handed out) is refused instead of queueing it
+    // twice.
+    //
+    // The io_uring backend lets the kernel pick buffers from a registered
+    // provided-buffer ring and only uses the memory part of this class.  The
+    // epoll backend emulates the same behaviour with the user-space free list.
+    //
+    // Thread safety: none -- accessed from the thread driving the async instance.
+    struct buffer_pool {
+        // Upper bound on buf_size * count; backends refuse larger pools with ENOMEM.
+        static constexpr size_t max_bytes = size_t(1) << (sizeof(size_t) >= 8 ? 32 : 30);
+
+        static bool fits(size_t buf_size, uint16_t count) noexcept {
+            return count != 0 && buf_size <= max_bytes / count;
+        }
+
+        // The memory is allocated without throwing; check ok() before use.
+        buffer_pool(size_t buf_size, uint16_t count)
+            : data_(new (std::nothrow) char[buf_size * count])
+            , buf_size_(buf_size)
+            , count_(count)
+            , out_(count, false) {
+            free_.reserve(count);
+            for (uint16_t i = count; i > 0; --i) {
+                free_.push_back(static_cast<uint16_t>(i - 1));
+            }
+        }
+
+        bool ok() const noexcept { return data_ != nullptr; }
+
+        char* buffer(uint16_t bid) noexcept { return data_.get() + bid * buf_size_; }
+        size_t buf_size() const noexcept { return buf_size_; }
+        uint16_t count() const noexcept { return count_; }
+        bool valid(uint16_t bid) const noexcept { return bid < count_; }
+
+        // --------------- ownership ---------------
+
+        // bid was handed to the caller by a completion.
+        void take(uint16_t bid) noexcept { out_[bid] = true; }
+
+        // The caller gives bid back; false if it was not out.
+        bool give_back(uint16_t bid) noexcept {
+            if (!out_[bid]) return false;
+            out_[bid] = false;
+            return true;
+        }
+
+        // --------------- user-space free list ---------------
+
+        bool acquire(uint16_t& bid) noexcept {
+            if (free_.empty()) return false;
+            bid = free_.back();
+            free_.pop_back();
+            take(bid);
+            return true;
+        }
+
+        bool release(uint16_t bid) {
+            if (!give_back(bid)) return false;
+            free_.push_back(bid);
+            return true;
+        }
+
+    private:
+        std::unique_ptr<char[]> data_;
+        size_t buf_size_;
+        uint16_t count_;
+        std::vector<bool> out_;
+        std::vector<uint16_t> free_;
+    };
+
+}  // namespace bee::async
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 
 namespace bee::async {
@@ -58,37 +59,106 @@ namespace bee::async {
         // the buffered data.  Returns the number of bytes from head up to and
         // including the last byte of the found sequence, or 0 if not found.
         // seplen must be >= 1.
-        size_t find(const char* sep, size_t seplen) const noexcept {
+        //
+        // Candidates are located with memchr on sep[0] over each contiguous
+        // segment of the ring.  The offset where a search stopped is
+        // remembered per separator (up to kScanSep bytes), so polling for
+        // a line as data trickles in only looks at newly committed bytes.
+        size_t find(const char* sep, size_t seplen) noexcept {
             size_t n = size();
             if (n < seplen) return 0;
-            size_t limit = n - seplen + 1;
-            for (size_t i = 0; i < limit; ++i) {
-                bool match = true;
-                for (size_t j = 0; j < seplen; ++j) {
-                    if (data_[(head_ + i + j) & (cap_ - 1)] != sep[j]) {
-                        match = false;
-                        break;
-                    }
+            size_t limit = n - seplen + 1;  // candidate starts are [0, limit)
+            size_t i     = 0;
+            if (scan_seplen_ == seplen && memcmp(scan_sep_, sep, seplen) == 0 && scan_ > head_) {
+                i = scan_ - head_;
+            }
+            while (i < limit) {
+                size_t idx    = (head_ + i) & (cap_ - 1);
+                size_t seg    = (std::min)(limit - i, cap_ - idx);
+                const void* p = memchr(data_ + idx, static_cast<unsigned char>(sep[0]), seg);
+                if (!p) {
+                    i += seg;
+                    continue;
+                }
+                i += static_cast<size_t>(static_cast<const char*>(p) - (data_ + idx));
+                if (match(head_ + i, sep, seplen)) {
+                    remember(sep, seplen, head_ + i);
+                    return i + seplen;
                 }
-                if (match) return i + seplen;
+                i++;
             }
+            remember(sep, seplen, head_ + limit);
             return 0;
         }
 
         // Copy exactly n bytes from the ring into dst and advance head.
         // Returns false (without modifying head) if fewer than n bytes are available.
         bool consume(char* dst, size_t n) noexcept {
-            if (size() < n) return false;
-            size_t idx   = head_ & (cap_ - 1);
+            if (!peek(dst, n)) return false;
+            head_ += n;
+            return true;
+        }
+
+        // Copy n bytes starting offset bytes after head into dst, leaving
+        // them buffered.  Returns false if fewer are available.
+        bool peek(char* dst, size_t n, size_t offset = 0) const noexcept {
+            if (size() < offset + n) return false;
+            size_t idx   = (head_ + offset) & (cap_ - 1);
             size_t first = (std::min)(n, cap_ - idx);
             memcpy(dst, data_ + idx, first);
             if (first < n) {
                 memcpy(dst + first, data_, n - first);
             }
-            head_ += n;
             return true;
         }
 
+        // Drop n buffered bytes (n <= size()).
+        void skip(size_t n) noexcept {
+            assert(n <= size());
+            head_ += n;
+        }
+
+        // --------------- length-prefixed frames ---------------
+
+        enum class frame_status {
+            complete,    // hdr and len describe a fully buffered frame
+            partial,     // more data is needed
+            too_large,   // len exceeds max, or the frame can never fit in the buffer
+            bad_header,  // varint longer than 10 bytes or above 2^64-1
+        };
+
+        // Decode the frame at head.  header is the prefix size in bytes (1,
+        // 2, 4 or 8, unsigned, big or little endian) or 0 for an unsigned
+        // LEB128 varint.  The prefix counts the body only.  On complete,
+        // hdr is the prefix length and len the body length; nothing is
+        // consumed.
+        frame_status frame(size_t header, bool little, size_t max, size_t& hdr, size_t& len) const noexcept {
+            uint8_t buf[10];
+            uint64_t v = 0;
+            if (header == 0) {
+                size_t n = (std::min)(size(), sizeof(buf));
+                peek(reinterpret_cast<char*>(buf), n);
+                size_t i = 0;
+                for (;; ++i) {
+                    if (i == n) return n == sizeof(buf) ? frame_status::bad_header : frame_status::partial;
+                    if (i == 9 && buf[i] > 1) return frame_status::bad_header;
+                    v |= static_cast<uint64_t>(buf[i] & 0x7f) << (7 * i);
+                    if ((buf[i] & 0x80) == 0) break;
+                }
+                hdr = i + 1;
+            } else {
+                assert(header <= 8);
+                if (!peek(reinterpret_cast<char*>(buf), header)) return frame_status::partial;
+                for (size_t i = 0; i < header; ++i) {
+                    v = (v << 8) | buf[little ? header - 1 - i : i];
+                }
+                hdr = header;
+            }
+            if (v > max || v > cap_ - hdr) return frame_status::too_large;
+            len = static_cast<size_t>(v);
+            return size() - hdr < len ? frame_status::partial : frame_status::complete;
+        }
+
         // --------------- lifecycle ---------------
 
         // Round sz up to the nearest power of two (minimum 16).
@@ -118,10 +188,33 @@ namespace bee::async {
         }
 
     private:
-        char* data_  = nullptr;
-        size_t cap_  = 0;  // capacity, always a power of two
-        size_t head_ = 0;  // consumer cursor (absolute, never wraps)
-        size_t tail_ = 0;  // producer cursor (absolute, never wraps)
+        static constexpr size_t kScanSep = 8;
+
+        // Whether sep occurs at absolute offset pos (may wrap).
+        bool match(size_t pos, const char* sep, size_t seplen) const noexcept {
+            size_t idx   = pos & (cap_ - 1);
+            size_t first = (std::min)(seplen, cap_ - idx);
+            return memcmp(data_ + idx, sep, first) == 0 && memcmp(data_, sep + first, seplen - first) == 0;
+        }
+
+        // No occurrence of sep starts before absolute offset pos.
+        void remember(const char* sep, size_t seplen, size_t pos) noexcept {
+            if (seplen > kScanSep) {
+                scan_seplen_ = 0;
+                return;
+            }
+            memcpy(scan_sep_, sep, seplen);
+            scan_seplen_ = seplen;
+            scan_        = pos;
+        }
+
+        char* data_         = nullptr;
+        size_t cap_         = 0;  // capacity, always a power of two
+        size_t head_        = 0;  // consumer cursor (absolute, never wraps)
+        size_t tail_        = 0;  // producer cursor (absolute, never wraps)
+        size_t scan_        = 0;  // find: scan_sep_ does not start before here (absolute)
+        size_t scan_seplen_ = 0;  // find: length of scan_sep_, 0 = nothing remembered
+        char scan_sep_[kScanSep];
     };
 
 }  // namespace bee::async
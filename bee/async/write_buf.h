@@ -4,6 +4,7 @@
 #include <bee/utility/dynarray.h>
 #include <bee/utility/span.h>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
@@ -56,6 +57,19 @@ namespace bee::async {
             lua_reqid_ = reqid;
         }
 
+        // Deadline for the whole drain, in ms from now (-1 = none).  Partial
+        // writes are resubmitted with whatever time is left.
+        void set_deadline(int timeout) noexcept {
+            has_deadline_ = timeout >= 0;
+            if (has_deadline_) deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+        }
+
+        int remaining() const noexcept {
+            if (!has_deadline_) return -1;
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline_ - std::chrono::steady_clock::now()).count();
+            return left > 0 ? static_cast<int>(left) : 0;
+        }
+
         // --------------- producer side ---------------
 
         // Enqueue a string entry. Returns true when buffered >= hwm (back-pressure signal).
@@ -122,6 +136,8 @@ namespace bee::async {
         // Fields valid only while in_flight_ == true:
         net::fd_t fd_        = net::fd_t {};  // socket being written to
         uint64_t lua_reqid_  = 0;             // Lua-assigned reqid for final completion
+        bool has_deadline_   = false;
+        std::chrono::steady_clock::time_point deadline_;
         // iov snapshot for the current in-flight write (entries may span multiple q items).
         // Built by build_iov(); must remain valid until the completion callback fires.
         dynarray<net::socket::iobuf> iov_cache_;
@@ -56,4 +56,8 @@ namespace bee::net {
     bool bpoll_ctl_mod(bpoll_handle handle, fd_t socket, const bpoll_event_t& event) noexcept;
     bool bpoll_ctl_del(bpoll_handle handle, fd_t socket) noexcept;
     int bpoll_wait(bpoll_handle handle, const span<bpoll_event_t>& events, int timeout) noexcept;
+    // Timeout in ns (-1 = infinite).  Linux 5.11+ (epoll_pwait2) and kqueue
+    // sleep with sub-millisecond precision; otherwise the timeout is
+    // rounded up to whole milliseconds.
+    int bpoll_wait_ns(bpoll_handle handle, const span<bpoll_event_t>& events, int64_t timeout_ns) noexcept;
 }
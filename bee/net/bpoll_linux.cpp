@@ -1,8 +1,14 @@
 #include <bee/net/bpoll.h>
 #include <bee/nonstd/to_underlying.h>
 #include <sys/epoll.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+
 namespace bee::net {
     static_assert(sizeof(bpoll_event) == sizeof(uint32_t));
     static_assert(sizeof(bpoll_event_t) == sizeof(epoll_event));
@@ -45,4 +51,23 @@ namespace bee::net {
     int bpoll_wait(bpoll_handle handle, const span<bpoll_event_t>& events, int timeout) noexcept {
         return ::epoll_wait(handle, (struct epoll_event*)events.data(), (int)events.size(), timeout);
     }
+
+    // Cleared once epoll_pwait2 turns out to be missing (before Linux 5.11).
+    static std::atomic<bool> g_pwait2 { true };
+
+    int bpoll_wait_ns(bpoll_handle handle, const span<bpoll_event_t>& events, int64_t timeout_ns) noexcept {
+#if defined(SYS_epoll_pwait2)
+        if (timeout_ns > 0 && g_pwait2.load(std::memory_order_relaxed)) {
+            struct {
+                int64_t tv_sec;
+                int64_t tv_nsec;
+            } ts { timeout_ns / 1000000000, timeout_ns % 1000000000 };
+            int n = static_cast<int>(::syscall(SYS_epoll_pwait2, handle, events.data(), (int)events.size(), &ts, nullptr, 0));
+            if (n >= 0 || errno != ENOSYS) return n;
+            g_pwait2.store(false, std::memory_order_relaxed);
+        }
+#endif
+        int ms = timeout_ns < 0 ? -1 : static_cast<int>(std::min<int64_t>((timeout_ns + 999999) / 1000000, INT_MAX));
+        return bpoll_wait(handle, events, ms);
+    }
 }
@@ -95,14 +95,14 @@ namespace bee::net {
             return set_kevent(fd, read_flags, write_flags, kqflags, ev.data.ptr);
         }
 
-        int bpoll_wait(const span<bpoll_event_t>& events, int timeout) noexcept {
+        int bpoll_wait(const span<bpoll_event_t>& events, int64_t timeout_ns) noexcept {
             hybrid_array<struct kevent, 256> kev(events.size());
             struct timespec t, *timeop = &t;
-            if (timeout < 0) {
+            if (timeout_ns < 0) {
                 timeop = NULL;
             } else {
-                t.tv_sec  = timeout / 1000l;
-                t.tv_nsec = timeout % 1000l * 1000000l;
+                t.tv_sec  = static_cast<time_t>(timeout_ns / 1000000000);
+                t.tv_nsec = static_cast<long>(timeout_ns % 1000000000);
             }
             int n = ::kevent(kq, NULL, 0, kev.data(), kev.size(), timeop);
             if (n == -1) {
@@ -202,6 +202,15 @@ namespace bee::net {
             return -1;
         }
         auto ep = (poller*)handle;
-        return ep->bpoll_wait(events, timeout);
+        return ep->bpoll_wait(events, timeout < 0 ? -1 : static_cast<int64_t>(timeout) * 1000000);
+    }
+
+    int bpoll_wait_ns(bpoll_handle handle, const span<bpoll_event_t>& events, int64_t timeout_ns) noexcept {
+        if (handle == invalid_bpoll_handle) {
+            errno = EBADF;
+            return -1;
+        }
+        auto ep = (poller*)handle;
+        return ep->bpoll_wait(events, timeout_ns);
     }
 }
@@ -3,6 +3,9 @@
 #include <bee/win/afd/afd.h>
 #include <bee/win/afd/poller.h>
 
+#include <algorithm>
+#include <climits>
+
 namespace bee::net {
     bpoll_handle bpoll_create() noexcept {
         afd::afd_context ctx;
@@ -90,4 +93,9 @@ namespace bee::net {
         auto ep = (afd::poller*)handle;
         return ep->wait(events, timeout);
     }
+
+    int bpoll_wait_ns(bpoll_handle handle, const span<bpoll_event_t>& events, int64_t timeout_ns) noexcept {
+        int ms = timeout_ns < 0 ? -1 : static_cast<int>(std::min<int64_t>((timeout_ns + 999999) / 1000000, INT_MAX));
+        return bpoll_wait(handle, events, ms);
+    }
 }
@@ -12,6 +12,16 @@
 #    include <netinet/in.h>
 #    include <netinet/tcp.h>
 #    include <signal.h>
+#    include <string.h>
+#    if defined(__linux__)
+#        include <netinet/udp.h>
+#        ifndef UDP_SEGMENT
+#            define UDP_SEGMENT 103
+#        endif
+#        ifndef UDP_GRO
+#            define UDP_GRO 104
+#        endif
+#    endif
 #    include <unistd.h>
 #    if defined(__APPLE__)
 #        include <sys/ioctl.h>
@@ -23,6 +33,7 @@
 #include <bee/net/endpoint.h>
 #include <bee/net/socket.h>
 #include <bee/nonstd/unreachable.h>
+#include <bee/utility/hybrid_array.h>
 
 namespace bee::net::socket {
     static bool net_success(int x) noexcept {
@@ -243,6 +254,43 @@ namespace bee::net::socket {
 #endif
     }
 
+#if defined(__linux__)
+    // Control message space for one UDP_SEGMENT (uint16_t) or UDP_GRO (int).
+    struct udp_cmsg {
+        alignas(struct cmsghdr) char buf[CMSG_SPACE(sizeof(int))];
+    };
+
+    static int udp_gro_segsize(struct msghdr& h) noexcept {
+        for (struct cmsghdr* c = CMSG_FIRSTHDR(&h); c; c = CMSG_NXTHDR(&h, c)) {
+            if (c->cmsg_level == IPPROTO_UDP && c->cmsg_type == UDP_GRO) {
+                int segsize;
+                memcpy(&segsize, CMSG_DATA(c), sizeof(segsize));
+                return segsize;
+            }
+        }
+        return 0;
+    }
+
+    static void udp_gso_segsize(struct msghdr& h, udp_cmsg& buf, int segsize) noexcept {
+        h.msg_control     = buf.buf;
+        h.msg_controllen  = CMSG_SPACE(sizeof(uint16_t));
+        struct cmsghdr* c = CMSG_FIRSTHDR(&h);
+        c->cmsg_level     = IPPROTO_UDP;
+        c->cmsg_type      = UDP_SEGMENT;
+        c->cmsg_len       = CMSG_LEN(sizeof(uint16_t));
+        const uint16_t v  = static_cast<uint16_t>(segsize);
+        memcpy(CMSG_DATA(c), &v, sizeof(v));
+    }
+#else
+    static void unsupported_option() noexcept {
+#    if defined(_WIN32)
+        ::WSASetLastError(WSAENOPROTOOPT);
+#    else
+        errno = ENOPROTOOPT;
+#    endif
+    }
+#endif
+
     bool setoption(fd_t s, option opt, int value) noexcept {
         switch (opt) {
         case option::reuseaddr:
@@ -253,6 +301,21 @@ namespace bee::net::socket {
             return setoption(s, SOL_SOCKET, SO_RCVBUF, value);
         case option::nodelay:
             return setoption(s, IPPROTO_TCP, TCP_NODELAY, value);
+        case option::udp_segment:
+        case option::udp_gro:
+#if defined(__linux__)
+            return setoption(s, IPPROTO_UDP, opt == option::udp_segment ? UDP_SEGMENT : UDP_GRO, value);
+#else
+            unsupported_option();
+            return false;
+#endif
+        case option::busy_poll:
+#if defined(__linux__)
+            return setoption(s, SOL_SOCKET, SO_BUSY_POLL, value);
+#else
+            unsupported_option();
+            return false;
+#endif
         default:
             std::unreachable();
         }
@@ -471,6 +534,98 @@ namespace bee::net::socket {
         return status::success;
     }
 
+    // n datagrams were received.  Linux moves the whole batch with one
+    // recvmmsg(2); elsewhere it is a recvfrom loop that stops at the first
+    // datagram that would block.
+    status recvmmsg(fd_t s, int& n, span<datagram> msgs) noexcept {
+#if defined(__linux__)
+        hybrid_array<struct mmsghdr, 32> hdrs(msgs.size());
+        hybrid_array<struct iovec, 32> iov(msgs.size());
+        hybrid_array<udp_cmsg, 32> ctl(msgs.size());
+        for (size_t i = 0; i < msgs.size(); ++i) {
+            auto& m          = msgs[i];
+            auto& h          = hdrs[i].msg_hdr;
+            iov[i]           = { m.buf, static_cast<size_t>(m.len) };
+            hdrs[i]          = {};
+            h.msg_iov        = &iov[i];
+            h.msg_iovlen     = 1;
+            h.msg_control    = ctl[i].buf;
+            h.msg_controllen = sizeof(ctl[i].buf);
+            if (m.ep) {
+                h.msg_name    = m.ep->out_addr();
+                h.msg_namelen = *m.ep->out_addrlen();
+            }
+        }
+        n = ::recvmmsg(s, hdrs.data(), static_cast<unsigned int>(msgs.size()), 0, nullptr);
+        if (n < 0) {
+            return wait_finish() ? status::wait : status::failed;
+        }
+        for (int i = 0; i < n; ++i) {
+            msgs[i].len     = static_cast<int>(hdrs[i].msg_len);
+            msgs[i].segsize = udp_gro_segsize(hdrs[i].msg_hdr);
+            if (msgs[i].ep) {
+                *msgs[i].ep->out_addrlen() = hdrs[i].msg_hdr.msg_namelen;
+            }
+        }
+        return status::success;
+#else
+        n = 0;
+        for (auto& m : msgs) {
+            endpoint tmp;
+            int rc;
+            status st = recvfrom(s, rc, m.ep ? *m.ep : tmp, m.buf, m.len);
+            if (st != status::success) {
+                return n > 0 ? status::success : st;
+            }
+            m.len     = rc;
+            m.segsize = 0;
+            n++;
+        }
+        return status::success;
+#endif
+    }
+
+    // n datagrams were sent; the rest of the batch was not attempted.
+    // segsize is honoured on Linux only; elsewhere each entry is sent whole.
+    status sendmmsg(fd_t s, int& n, span<const datagram> msgs) noexcept {
+#if defined(__linux__)
+        hybrid_array<struct mmsghdr, 32> hdrs(msgs.size());
+        hybrid_array<struct iovec, 32> iov(msgs.size());
+        hybrid_array<udp_cmsg, 32> ctl(msgs.size());
+        for (size_t i = 0; i < msgs.size(); ++i) {
+            auto& m      = msgs[i];
+            auto& h      = hdrs[i].msg_hdr;
+            iov[i]       = { m.buf, static_cast<size_t>(m.len) };
+            hdrs[i]      = {};
+            h.msg_iov    = &iov[i];
+            h.msg_iovlen = 1;
+            if (m.ep) {
+                h.msg_name    = const_cast<sockaddr*>(m.ep->addr());
+                h.msg_namelen = m.ep->addrlen();
+            }
+            if (m.segsize > 0) {
+                udp_gso_segsize(h, ctl[i], m.segsize);
+            }
+        }
+        n = ::sendmmsg(s, hdrs.data(), static_cast<unsigned int>(msgs.size()), MSG_NOSIGNAL);
+        if (n < 0) {
+            return wait_finish() ? status::wait : status::failed;
+        }
+        return status::success;
+#else
+        n = 0;
+        for (auto& m : msgs) {
+            int rc;
+            status st = m.ep ? sendto(s, rc, m.buf, m.len, *m.ep) : send(s, rc, m.buf, m.len);
+            if (st != status::success) {
+                return n > 0 ? status::success : st;
+            }
+            n++;
+        }
+        return status::success;
+#endif
+    }
+
     bool getpeername(fd_t s, endpoint& ep) noexcept {
         const int ok = ::getpeername(s, ep.out_addr(), ep.out_addrlen());
         return net_success(ok);
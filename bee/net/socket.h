@@ -43,6 +43,9 @@ namespace bee::net::socket {
         sndbuf,
         rcvbuf,
         nodelay,
+        udp_segment,  // Linux: UDP GSO segment size for every send (0 = off)
+        udp_gro,      // Linux: coalesce received datagrams (see datagram::segsize)
+        busy_poll,    // Linux: SO_BUSY_POLL, us to busy-poll the device queue on a blocking receive
     };
 
     enum class fd_flags {
@@ -72,6 +75,19 @@ namespace bee::net::socket {
     };
 #endif
 
+    // One datagram of a recvmmsg/sendmmsg batch.
+    //
+    // With UDP GSO/GRO (Linux) one entry carries several equally sized
+    // segments back to back: on send the kernel cuts buf into segsize-byte
+    // datagrams, on receive segsize reports the size the coalesced buffer
+    // must be split at (the last segment may be shorter).
+    struct datagram {
+        char* buf;
+        int len;          // recvmmsg: buffer size in, bytes received out; sendmmsg: bytes to send
+        endpoint* ep;     // recvmmsg: filled with the sender; sendmmsg: destination (nullptr when connected)
+        int segsize = 0;  // recvmmsg: GRO segment size out, 0 if not coalesced; sendmmsg: GSO segment size, 0 = none
+    };
+
     bool initialize() noexcept;
     fd_t open(protocol protocol, fd_flags flags = fd_flags::nonblock) noexcept;
     bool pair(fd_t sv[2], fd_flags flags = fd_flags::nonblock) noexcept;
@@ -89,6 +105,8 @@ namespace bee::net::socket {
     status sendv(fd_t s, int& rc, span<const iobuf> bufs) noexcept;
     status recvfrom(fd_t s, int& rc, endpoint& ep, char* buf, int len) noexcept;
     status sendto(fd_t s, int& rc, const char* buf, int len, const endpoint& ep) noexcept;
+    status recvmmsg(fd_t s, int& n, span<datagram> msgs) noexcept;
+    status sendmmsg(fd_t s, int& n, span<const datagram> msgs) noexcept;
     bool getpeername(fd_t s, endpoint& ep) noexcept;
     bool getsockname(fd_t s, endpoint& ep) noexcept;
     bool errcode(fd_t s, int& err) noexcept;
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace bee {
+    // Adaptive busy-poll window in front of a blocking wait.
+    //
+    // wait() first spins on a non-blocking poll for up to window_ns, and
+    // only then blocks for the rest of the timeout.  The window adapts
+    // like cpuidle haltpoll: an event that arrives while blocked, but
+    // sooner than max_ns, means a longer spin would have caught it, so the
+    // window doubles; a block that outlasts max_ns (or times out) means
+    // the loop is idle, so the window halves.  max_ns == 0 disables
+    // spinning.
+    struct busy_poll {
+        int64_t max_ns     = 0;
+        int64_t window_ns  = 0;
+        uint64_t spin_ns   = 0;  // time spent spinning
+        uint64_t block_ns  = 0;  // time spent blocked
+        uint64_t spin_hits = 0;  // waits satisfied while spinning
+
+        explicit busy_poll(int64_t max = 0) noexcept
+            : max_ns(max)
+            , window_ns(max) {}
+
+        // poll() -> int: non-blocking, returns the number of events.
+        // block(timeout_ns) -> int: blocks up to timeout_ns (-1 = no limit).
+        template <typename Poll, typename Block>
+        int wait(int64_t timeout_ns, Poll&& poll, Block&& block) {
+            using clock = std::chrono::steady_clock;
+            if (max_ns <= 0 || timeout_ns == 0) {
+                return block(timeout_ns);
+            }
+            auto start   = clock::now();
+            int64_t spin = timeout_ns < 0 ? window_ns : std::min(window_ns, timeout_ns);
+            int64_t spent;
+            for (;;) {
+                int n = poll();
+                spent = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+                if (n > 0) {
+                    spin_ns += spent;
+                    spin_hits++;
+                    return n;
+                }
+                if (spent >= spin) break;
+            }
+            spin_ns += spent;
+            int64_t rest = timeout_ns < 0 ? -1 : std::max<int64_t>(timeout_ns - spent, 0);
+            if (rest == 0) {
+                window_ns /= 2;
+                return 0;
+            }
+            auto blocked_at = clock::now();
+            int n           = block(rest);
+            int64_t blocked = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - blocked_at).count();
+            block_ns += blocked;
+            if (n > 0 && blocked < max_ns) {
+                window_ns = std::min(max_ns, std::max(window_ns * 2, max_ns / 8));
+            } else {
+                window_ns /= 2;
+            }
+            return n;
+        }
+    };
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace bee {
+    // Pool of T objects addressed by a 32-bit slot index.
+    //
+    // Slots live in fixed-size chunks that are never moved, so a slot's address
+    // stays valid while it is in use (it may be handed to the kernel).  Freed
+    // slots are reused in LIFO order and keep their contents, which lets
+    // members such as std::vector keep their capacity across uses.  Memory is
+    // only allocated when every existing slot is busy.
+    template <typename T, size_t ChunkSize = 256>
+    class slab {
+    public:
+        uint32_t alloc() {
+            if (free_.empty()) {
+                grow();
+            }
+            uint32_t idx = free_.back();
+            free_.pop_back();
+            return idx;
+        }
+
+        void free(uint32_t idx) {
+            assert(idx < capacity());
+            free_.push_back(idx);
+        }
+
+        T& operator[](uint32_t idx) noexcept {
+            assert(idx < capacity());
+            return chunks_[idx / ChunkSize][idx % ChunkSize];
+        }
+
+        const T& operator[](uint32_t idx) const noexcept {
+            assert(idx < capacity());
+            return chunks_[idx / ChunkSize][idx % ChunkSize];
+        }
+
+        size_t capacity() const noexcept { return chunks_.size() * ChunkSize; }
+        size_t in_use() const noexcept { return capacity() - free_.size(); }
+
+    private:
+        void grow() {
+            uint32_t base = static_cast<uint32_t>(capacity());
+            chunks_.emplace_back(std::make_unique<T[]>(ChunkSize));
+            free_.reserve(capacity());
+            for (size_t i = ChunkSize; i > 0; --i) {
+                free_.push_back(base + static_cast<uint32_t>(i - 1));
+            }
+        }
+
+        std::vector<std::unique_ptr<T[]>> chunks_;
+        std::vector<uint32_t> free_;
+    };
+}
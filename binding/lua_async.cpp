@@ -14,6 +14,26 @@
 #include <bee/utility/dynarray.h>
 #include <bee/utility/span.h>
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#    include <3rd/lua-seri/lua-seri.h>
+#    include <bee/thread/spinlock.h>
+#    include <fcntl.h>
+#    include <string.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+
+#    include <map>
+#    include <mutex>
+#    include <shared_mutex>
+#    include <string>
+#endif
+
 namespace bee::lua_socket {
     net::fd_t& newfd(lua_State* L, net::fd_t fd);
     net::fd_t& checkfd(lua_State* L, int idx);
@@ -23,17 +43,80 @@ namespace bee::lua_socket {
 
 namespace bee::lua_async {
 
+    // Per-op deadlines are implemented by the Linux backends only; elsewhere
+    // optdeadline rejects the argument and the extra parameter is dropped.
+#if defined(__linux__)
+#    define DEADLINE(d) , (d)
+#else
+#    define DEADLINE(d)
+#endif
+
+#if defined(__linux__)
+    // Named entry point for async::post, shared with other threads the way
+    // bee.channel shares channels.  handle is reset when the owning async
+    // instance closes; posters hold mutex shared so they never race that.
+    struct mailbox {
+        using box = std::shared_ptr<mailbox>;
+        std::shared_mutex mutex;
+        async::async* handle = nullptr;
+    };
+
+    class mailboxmgr {
+    public:
+        mailbox::box create(std::string_view name, async::async* handle) {
+            std::unique_lock<spinlock> lk(mutex);
+            auto mb    = std::make_shared<mailbox>();
+            mb->handle = handle;
+            auto [r, ok] = mailboxes.emplace(std::string { name.data(), name.size() }, mb);
+            if (!ok) {
+                return nullptr;
+            }
+            return r->second;
+        }
+        void destroy(const mailbox::box& mb) {
+            std::unique_lock<spinlock> lk(mutex);
+            for (auto it = mailboxes.begin(); it != mailboxes.end(); ++it) {
+                if (it->second == mb) {
+                    mailboxes.erase(it);
+                    break;
+                }
+            }
+        }
+        mailbox::box query(std::string_view name) {
+            std::unique_lock<spinlock> lk(mutex);
+            auto it = mailboxes.find(std::string { name.data(), name.size() });
+            if (it != mailboxes.end()) {
+                return it->second;
+            }
+            return nullptr;
+        }
+
+    private:
+        std::map<std::string, mailbox::box> mailboxes;
+        spinlock mutex;
+    };
+
+    static mailboxmgr g_mailbox;
+
+    // An OP_POST completion carries a seri_pack buffer in request_id.
+    static void* post_payload(const async::io_completion& c) {
+        return reinterpret_cast<void*>(static_cast<uintptr_t>(c.request_id));
+    }
+#endif
+
     struct lua_async {
         std::unique_ptr<async::async> handle;
         luaref refs = nullptr;
         int i = 0;
         int n = 0;
         dynarray<async::io_completion> completions;
+#if defined(__linux__)
+        mailbox::box box;         // opened by asfd:mailbox(name)
+        uint64_t last_timer = 0;  // submit_timer ids are never reused
+#endif
         lua_async(size_t max_completions)
             : completions(max_completions) {}
-        ~lua_async() {
-            if (refs) luaref_close(refs);
-        }
+        ~lua_async();
     };
 
     static file_handle::value_type tofilefd(lua_State* L, int idx) {
@@ -115,7 +198,7 @@ namespace bee::lua_async {
     static bool wb_submit_all(lua_async& as, async::write_buf& wb) {
         if (wb.empty()) return true;
         auto iov = wb.build_iov();
-        if (!as.handle->submit_write(wb.target_fd(), iov, wb.request_id())) {
+        if (!as.handle->submit_write(wb.target_fd(), iov, wb.request_id() DEADLINE(wb.remaining()))) {
             return false;
         }
         wb.begin_flight();
@@ -160,25 +243,82 @@ namespace bee::lua_async {
         return true;
     }
 
-    // udata_r is consumed (unref'd) by this call.
-    static void push_udata(lua_State* L, lua_async& as, int udata_r) {
+    // udata_r is consumed (unref'd) by this call, unless more completions
+    // will follow for the same multishot request.
+    static void push_udata(lua_State* L, lua_async& as, int udata_r, bool more = false) {
         if (udata_r) {
             luaref_get(as.refs, L, udata_r);
-            luaref_unref(as.refs, udata_r);
+            if (!more) luaref_unref(as.refs, udata_r);
         } else {
             lua_pushnil(L);
         }
     }
 
+    static bool has_more(const async::io_completion& c) {
+#if defined(__linux__)
+        return c.more;
+#else
+        (void)c;
+        return false;
+#endif
+    }
+
+#if defined(__linux__)
+    // fopen-style mode for an fd returned by submit_file_open.
+    static const char* fdopen_mode(int fd) {
+        int fl      = fcntl(fd, F_GETFL);
+        bool append = (fl & O_APPEND) != 0;
+        switch (fl & O_ACCMODE) {
+        case O_WRONLY:
+            return append ? "a" : "w";
+        case O_RDWR:
+            return append ? "a+" : "r+";
+        default:
+            return "r";
+        }
+    }
+
+    static void push_statx(lua_State* L, const async::statx_result& st) {
+        lua_createtable(L, 0, 11);
+        auto set = [&](const char* name, lua_Integer v) {
+            lua_pushinteger(L, v);
+            lua_setfield(L, -2, name);
+        };
+        set("size", static_cast<lua_Integer>(st.stx_size));
+        set("mode", st.stx_mode);
+        set("nlink", st.stx_nlink);
+        set("uid", st.stx_uid);
+        set("gid", st.stx_gid);
+        set("ino", static_cast<lua_Integer>(st.stx_ino));
+        set("blocks", static_cast<lua_Integer>(st.stx_blocks));
+        set("blksize", st.stx_blksize);
+        set("atime", st.stx_atime.tv_sec);
+        set("mtime", st.stx_mtime.tv_sec);
+        set("ctime", st.stx_ctime.tv_sec);
+    }
+#endif
+
     // ---- completion iterator ----
 
-    static int async_completions(lua_State* L) {
-        auto& as = *(lua_async*)lua_touserdata(L, lua_upvalueindex(1));
+    // Push the values of the next completion (op, udata, status, data,
+    // errcode[, bid]) and return how many; 0 once the batch is drained.
+    static int next_completion(lua_State* L, lua_async& as) {
     again:
         if (as.i >= as.n) return 0;
 
         const auto& c = as.completions[as.i];
         as.i++;
+#if defined(__linux__)
+        if (c.op == async::async_op::post) {
+            // The posted value stands in the udata slot.
+            lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(c.op)));
+            seri_unpackptr(L, post_payload(c));
+            lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(c.status)));
+            lua_pushinteger(L, 0);
+            lua_pushinteger(L, 0);
+            return 5;
+        }
+#endif
         int buf_r   = get_buf_ref(c.request_id);
         int udata_r = get_udata_ref(c.request_id);
 
@@ -227,8 +367,102 @@ namespace bee::lua_async {
             return 5;
         }
 
+#if defined(__linux__)
+        if (c.op == async::async_op::recv) {
+            // buffer-select receive: buf_r pins the buffer group id.  A buffer
+            // taken by a failed receive is recycled here; on success its bid is
+            // returned as the sixth value and the caller must recycle it.
+            uint16_t group = 0;
+            if (buf_r) {
+                luaref_get(as.refs, L, buf_r);
+                group = static_cast<uint16_t>(lua_tointeger(L, -1));
+                lua_pop(L, 1);
+                if (!c.more) luaref_unref(as.refs, buf_r);
+            }
+            lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(c.op)));
+            push_udata(L, as, udata_r, c.more);
+            lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(c.status)));
+            lua_pushinteger(L, static_cast<lua_Integer>(c.bytes_transferred));
+            lua_pushinteger(L, static_cast<lua_Integer>(c.error_code));
+            if (c.buffer_id < 0) return 5;
+            if (c.status != async::async_status::success) {
+                as.handle->recycle_buffer(group, static_cast<uint16_t>(c.buffer_id));
+                return 5;
+            }
+            lua_pushinteger(L, static_cast<lua_Integer>(c.buffer_id));
+            return 6;
+        }
+
+        if (c.op == async::async_op::file_open) {
+            // The path was pinned until the kernel had read it.
+            unref_buf(as, buf_r);
+            lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(c.op)));
+            push_udata(L, as, udata_r);
+            if (c.status != async::async_status::success) {
+                lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(c.status)));
+                lua_pushinteger(L, 0);
+                lua_pushinteger(L, static_cast<lua_Integer>(c.error_code));
+                return 5;
+            }
+            int fd  = static_cast<int>(c.bytes_transferred);
+            FILE* f = fdopen(fd, fdopen_mode(fd));
+            if (!f) {
+                int ec = errno;
+                close(fd);
+                lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(async::async_status::error)));
+                lua_pushinteger(L, 0);
+                lua_pushinteger(L, static_cast<lua_Integer>(ec));
+                return 5;
+            }
+            lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(c.status)));
+            lua::newfile(L, f);
+            lua_pushinteger(L, 0);
+            return 5;
+        }
+
+        if (c.op == async::async_op::recvfrom) {
+            // buf_r pins the receive buffer (which in turn pins the endpoint).
+            // A GRO-coalesced receive returns its segment size as the sixth value.
+            lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(c.op)));
+            push_udata(L, as, udata_r);
+            lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(c.status)));
+            bool coalesced = false;
+            if (c.status == async::async_status::success && buf_r) {
+                luaref_get(as.refs, L, buf_r);
+                const char* buf = static_cast<const char*>(lua_touserdata(L, -1));
+                lua_pushlstring(L, buf, c.bytes_transferred);
+                lua_remove(L, -2);
+                coalesced = c.buffer_id > 0;
+            } else {
+                lua_pushinteger(L, 0);
+            }
+            unref_buf(as, buf_r);
+            lua_pushinteger(L, static_cast<lua_Integer>(c.error_code));
+            if (!coalesced) return 5;
+            lua_pushinteger(L, static_cast<lua_Integer>(c.buffer_id));
+            return 6;
+        }
+
+        if (c.op == async::async_op::file_statx) {
+            lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(c.op)));
+            push_udata(L, as, udata_r);
+            lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(c.status)));
+            if (c.status == async::async_status::success && buf_r) {
+                luaref_get(as.refs, L, buf_r);
+                auto* st = static_cast<const async::statx_result*>(lua_touserdata(L, -1));
+                lua_pop(L, 1);
+                push_statx(L, *st);
+            } else {
+                lua_pushinteger(L, 0);
+            }
+            unref_buf(as, buf_r);
+            lua_pushinteger(L, static_cast<lua_Integer>(c.error_code));
+            return 5;
+        }
+#endif
+
         lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(c.op)));
-        push_udata(L, as, udata_r);
+        push_udata(L, as, udata_r, has_more(c));
         lua_pushinteger(L, static_cast<lua_Integer>(std::to_underlying(c.status)));
 
         switch (c.op) {
@@ -269,6 +503,32 @@ namespace bee::lua_async {
         return 5;
     }
 
+    static int async_completions(lua_State* L) {
+        auto& as = *(lua_async*)lua_touserdata(L, lua_upvalueindex(1));
+        return next_completion(L, as);
+    }
+
+    // wait_into/poll_into store each completion as kCompletionStride
+    // consecutive array slots of the caller's table, in iterator order;
+    // a missing bid is stored as nil.
+    static constexpr int kCompletionStride = 6;
+
+    static int fill_completions(lua_State* L, lua_async& as, int t) {
+        lua_Integer count = 0;
+        while (int nret = next_completion(L, as)) {
+            for (int k = nret; k < kCompletionStride; ++k) {
+                lua_pushnil(L);
+            }
+            lua_Integer base = count * kCompletionStride;
+            for (int k = kCompletionStride; k >= 1; --k) {
+                lua_rawseti(L, t, base + k);
+            }
+            count++;
+        }
+        lua_pushinteger(L, count);
+        return 1;
+    }
+
     // ---- fd helpers ----
 
     // Accept both socket userdata (from bee.socket) and light userdata (from channel:fd()).
@@ -279,6 +539,18 @@ namespace bee::lua_async {
         return lua_socket::checkfd(L, idx);
     }
 
+    // Optional deadline in ms following the udata argument; -1 if absent.
+    static int optdeadline(lua_State* L, int idx) {
+        if (lua_isnoneornil(L, idx)) return -1;
+#if defined(__linux__)
+        int deadline = lua::checkinteger<int>(L, idx);
+        luaL_argcheck(L, deadline >= 0, idx, "deadline must be non-negative");
+        return deadline;
+#else
+        return luaL_error(L, "deadline is not supported on this platform");
+#endif
+    }
+
     // Make a packed request_id and pin both values.
     static uint64_t pin(lua_State* L, lua_async& as, int buf_idx, int udata_idx) {
         lua_pushvalue(L, buf_idx);
@@ -308,6 +580,7 @@ namespace bee::lua_async {
         auto& wb     = lua::checkudata<async::write_buf>(L, 2);
         net::fd_t fd = lua_socket::checkfd(L, 3);
         luaL_checkany(L, 4);
+        int deadline = optdeadline(L, 5);
 
         if (wb.idle()) {
             lua_pushboolean(L, 1);
@@ -316,6 +589,7 @@ namespace bee::lua_async {
 
         uint64_t id = pin(L, as, 2, 4);
         wb.set_target(fd, id);
+        wb.set_deadline(deadline);
 
         if (!wb_submit_all(as, wb)) {
             pin_release(as, id);
@@ -334,6 +608,7 @@ namespace bee::lua_async {
         auto& rb     = lua::checkudata<async::read_buf>(L, 2);
         net::fd_t fd = lua_socket::checkfd(L, 3);
         luaL_checkany(L, 4);
+        int deadline = optdeadline(L, 5);
 
         size_t len1 = rb.write_len();
         if (len1 == 0) {
@@ -354,7 +629,7 @@ namespace bee::lua_async {
         }
 
         uint64_t id = pin(L, as, 2, 4);
-        if (!as.handle->submit_read(fd, span<const net::socket::iobuf>(bufs, nbufs), id)) {
+        if (!as.handle->submit_read(fd, span<const net::socket::iobuf>(bufs, nbufs), id DEADLINE(deadline))) {
             pin_release(as, id);
             return lua::return_net_error(L, "submit_read");
         }
@@ -366,8 +641,9 @@ namespace bee::lua_async {
         auto& as     = lua::checkudata<lua_async>(L, 1);
         net::fd_t fd = lua_socket::checkfd(L, 2);
         luaL_checkany(L, 3);
-        uint64_t id = pin_udata(L, as, 3);
-        if (!as.handle->submit_accept(fd, id)) {
+        int deadline = optdeadline(L, 4);
+        uint64_t id  = pin_udata(L, as, 3);
+        if (!as.handle->submit_accept(fd, id DEADLINE(deadline))) {
             pin_release(as, id);
             return lua::return_net_error(L, "submit_accept");
         }
@@ -375,29 +651,47 @@ namespace bee::lua_async {
         return 1;
     }
 
+#if defined(__linux__)
+    // submit_accept_multishot(asfd, listen_fd, udata)
+    // Produces one OP_ACCEPT completion per connection until an error or cancel;
+    // udata stays pinned until the final completion.
+    static int async_submit_accept_multishot(lua_State* L) {
+        auto& as     = lua::checkudata<lua_async>(L, 1);
+        net::fd_t fd = lua_socket::checkfd(L, 2);
+        luaL_checkany(L, 3);
+        uint64_t id = pin_udata(L, as, 3);
+        if (!as.handle->submit_accept_multishot(fd, id)) {
+            pin_release(as, id);
+            return lua::return_net_error(L, "submit_accept_multishot");
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+#endif
+
     static int async_submit_connect(lua_State* L) {
         auto& as     = lua::checkudata<lua_async>(L, 1);
         net::fd_t fd = lua_socket::checkfd(L, 2);
         net::endpoint stack_ep;
         const net::endpoint* ep_ptr;
-        int udata_idx;
-        if (lua_type(L, 3) == LUA_TUSERDATA) {
-            ep_ptr    = &lua_socket::to_endpoint(L, 3, stack_ep);
-            udata_idx = 4;
+        bool is_ep    = lua_type(L, 3) == LUA_TUSERDATA;
+        int udata_idx = is_ep ? 4 : 5;
+        luaL_checkany(L, udata_idx);
+        int deadline = optdeadline(L, udata_idx + 1);
+        if (is_ep) {
+            ep_ptr = &lua_socket::to_endpoint(L, 3, stack_ep);
             lua_pushvalue(L, 3);
         } else {
             auto name = lua::checkstrview(L, 3);
             auto port = lua::checkinteger<uint16_t>(L, 4);
-            udata_idx = 5;
             auto& ep  = lua_socket::new_endpoint(L);
             if (!net::endpoint::ctor_hostname(ep, name, port))
                 return lua::return_error(L, "invalid endpoint");
             ep_ptr = &ep;
         }
-        luaL_checkany(L, udata_idx);
         uint64_t id = pin(L, as, lua_gettop(L), udata_idx);
         lua_pop(L, 1);
-        if (!as.handle->submit_connect(fd, *ep_ptr, id)) {
+        if (!as.handle->submit_connect(fd, *ep_ptr, id DEADLINE(deadline))) {
             pin_release(as, id);
             return lua::return_net_error(L, "submit_connect");
         }
@@ -459,6 +753,370 @@ namespace bee::lua_async {
         return 1;
     }
 
+#if defined(__linux__)
+    // submit_timer(asfd, ms, udata) -> timer id
+    static int async_submit_timer(lua_State* L) {
+        auto& as    = lua::checkudata<lua_async>(L, 1);
+        int timeout = lua::checkinteger<int>(L, 2);
+        luaL_argcheck(L, timeout >= 0, 2, "timeout must be non-negative");
+        luaL_checkany(L, 3);
+        uint64_t id       = pin_udata(L, as, 3);
+        uint64_t timer_id = as.last_timer + 1;
+        if (!as.handle->submit_timer(timeout, timer_id, id)) {
+            pin_release(as, id);
+            return lua::return_net_error(L, "submit_timer");
+        }
+        as.last_timer = timer_id;
+        lua_pushinteger(L, static_cast<lua_Integer>(timer_id));
+        return 1;
+    }
+
+    // cancel_timer(asfd, id): the timer completes with CANCEL unless it already fired.
+    static int async_cancel_timer(lua_State* L) {
+        auto& as = lua::checkudata<lua_async>(L, 1);
+        auto id  = lua::checkinteger<lua_Integer>(L, 2);
+        as.handle->cancel_timer(static_cast<uint64_t>(id));
+        return 0;
+    }
+
+    // submit_file_open(asfd, path, mode, udata); mode is an io.open mode string.
+    static int async_submit_file_open(lua_State* L) {
+        auto& as         = lua::checkudata<lua_async>(L, 1);
+        const char* path = luaL_checkstring(L, 2);
+        const char* mode = luaL_optstring(L, 3, "r");
+        luaL_checkany(L, 4);
+        int flags;
+        switch (mode[0]) {
+        case 'r':
+            flags = O_RDONLY;
+            break;
+        case 'w':
+            flags = O_WRONLY | O_CREAT | O_TRUNC;
+            break;
+        case 'a':
+            flags = O_WRONLY | O_CREAT | O_APPEND;
+            break;
+        default:
+            return luaL_argerror(L, 3, "invalid mode");
+        }
+        const char* rest = mode + 1;
+        if (*rest == '+') {
+            flags = (flags & ~O_ACCMODE) | O_RDWR;
+            rest++;
+        }
+        luaL_argcheck(L, rest[strspn(rest, "b")] == '\0', 3, "invalid mode");
+        uint64_t id = pin(L, as, 2, 4);
+        if (!as.handle->submit_file_open(path, flags | O_CLOEXEC, 0666, id)) {
+            pin_release(as, id);
+            return lua::return_net_error(L, "submit_file_open");
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    // submit_file_close(asfd, file, udata)
+    // The Lua file is closed right away on a duplicate of its fd, so the
+    // final close -- the one that releases the file -- runs asynchronously.
+    static int async_submit_file_close(lua_State* L) {
+        auto& as       = lua::checkudata<lua_async>(L, 1);
+        luaL_Stream* p = lua::tofile(L, 2);
+        luaL_checkany(L, 3);
+        if (!p->closef) return luaL_error(L, "attempt to use a closed file");
+        int fd = fileno(p->f);
+        int nd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        if (nd < 0) return lua::return_net_error(L, "submit_file_close");
+        as.handle->unregister_fd(fd);
+        fclose(p->f);
+        p->closef   = nullptr;
+        uint64_t id = pin_udata(L, as, 3);
+        if (!as.handle->submit_file_close(nd, id)) {
+            pin_release(as, id);
+            close(nd);
+            return lua::return_net_error(L, "submit_file_close");
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    static int submit_fsync(lua_State* L, bool datasync) {
+        auto& as       = lua::checkudata<lua_async>(L, 1);
+        luaL_Stream* p = lua::tofile(L, 2);
+        luaL_checkany(L, 3);
+        if (!p->closef) return luaL_error(L, "attempt to use a closed file");
+        fflush(p->f);
+        uint64_t id = pin_udata(L, as, 3);
+        if (!as.handle->submit_fsync(fileno(p->f), datasync, id)) {
+            pin_release(as, id);
+            return lua::return_net_error(L, datasync ? "submit_fdatasync" : "submit_fsync");
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    // submit_fsync(asfd, file, udata)
+    static int async_submit_fsync(lua_State* L) {
+        return submit_fsync(L, false);
+    }
+
+    // submit_fdatasync(asfd, file, udata)
+    static int async_submit_fdatasync(lua_State* L) {
+        return submit_fsync(L, true);
+    }
+
+    // submit_statx(asfd, path_or_file, udata)
+    // The result buffer also carries a copy of the path; both stay pinned
+    // until the completion.
+    static int async_submit_statx(lua_State* L) {
+        auto& as = lua::checkudata<lua_async>(L, 1);
+        luaL_checkany(L, 3);
+        int dirfd        = AT_FDCWD;
+        const char* path = "";
+        size_t len       = 0;
+        if (lua_type(L, 2) == LUA_TSTRING) {
+            path = lua_tolstring(L, 2, &len);
+        } else {
+            dirfd = tofilefd(L, 2);
+        }
+        auto* buf = static_cast<char*>(lua_newuserdatauv(L, sizeof(async::statx_result) + len + 1, 0));
+        char* cpy = buf + sizeof(async::statx_result);
+        memcpy(cpy, path, len + 1);
+        uint64_t id = pin(L, as, lua_gettop(L), 3);
+        lua_pop(L, 1);
+        if (!as.handle->submit_statx(dirfd, cpy, buf, id)) {
+            pin_release(as, id);
+            return lua::return_net_error(L, "submit_statx");
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    // submit_sendfile(asfd, sock, file, offset, len, udata)
+    // Sends len bytes of file starting at offset (len = nil: up to end of
+    // file) without copying through Lua.  The file stays pinned until the
+    // single OP_SENDFILE completion.
+    static int async_submit_sendfile(lua_State* L) {
+        auto& as           = lua::checkudata<lua_async>(L, 1);
+        net::fd_t fd       = lua_socket::checkfd(L, 2);
+        luaL_Stream* p     = lua::tofile(L, 3);
+        lua_Integer offset = luaL_optinteger(L, 4, 0);
+        luaL_checkany(L, 6);
+        if (!p->closef) return luaL_error(L, "attempt to use a closed file");
+        luaL_argcheck(L, offset >= 0, 4, "offset must be non-negative");
+        fflush(p->f);
+        int file = fileno(p->f);
+        lua_Integer len;
+        if (lua_isnoneornil(L, 5)) {
+            struct stat st;
+            if (fstat(file, &st) != 0) return lua::return_net_error(L, "submit_sendfile");
+            len = st.st_size - offset;
+        } else {
+            len = luaL_checkinteger(L, 5);
+        }
+        luaL_argcheck(L, len > 0, 5, "nothing to send");
+        uint64_t id = pin(L, as, 3, 6);
+        if (!as.handle->submit_sendfile(fd, file, offset, static_cast<uint64_t>(len), id)) {
+            pin_release(as, id);
+            return lua::return_net_error(L, "submit_sendfile");
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    // submit_relay(asfd, src, dst, opts, udata)
+    // Forwards src to dst inside the kernel until EOF on src or opts.limit
+    // bytes, then produces a single OP_RELAY completion with the total.
+    static int async_submit_relay(lua_State* L) {
+        auto& as      = lua::checkudata<lua_async>(L, 1);
+        net::fd_t src = lua_socket::checkfd(L, 2);
+        net::fd_t dst = lua_socket::checkfd(L, 3);
+        luaL_checkany(L, 5);
+        lua_Integer limit = 0;
+        if (!lua_isnoneornil(L, 4)) {
+            luaL_checktype(L, 4, LUA_TTABLE);
+            if (LUA_TNIL != lua_getfield(L, 4, "limit")) {
+                limit = luaL_checkinteger(L, -1);
+                if (limit <= 0) return luaL_error(L, "limit must be positive");
+            }
+            lua_pop(L, 1);
+        }
+        uint64_t id = pin_udata(L, as, 5);
+        if (!as.handle->submit_relay(src, dst, static_cast<uint64_t>(limit), id)) {
+            pin_release(as, id);
+            return lua::return_net_error(L, "submit_relay");
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    // submit_recvfrom(asfd, fd, ep, size, udata)
+    // Receives one datagram of at most size bytes; the sender is written into
+    // ep (an endpoint userdata) and the payload is returned as the data value.
+    static int async_submit_recvfrom(lua_State* L) {
+        auto& as        = lua::checkudata<lua_async>(L, 1);
+        net::fd_t fd    = lua_socket::checkfd(L, 2);
+        auto& ep        = lua::checkudata<net::endpoint>(L, 3);
+        lua_Integer len = luaL_checkinteger(L, 4);
+        luaL_checkany(L, 5);
+        if (len <= 0) return luaL_error(L, "size must be positive");
+        // The buffer userdata keeps ep alive until the completion.
+        void* buf = lua_newuserdatauv(L, static_cast<size_t>(len), 1);
+        lua_pushvalue(L, 3);
+        lua_setiuservalue(L, -2, 1);
+        uint64_t id = pin(L, as, lua_gettop(L), 5);
+        lua_pop(L, 1);
+        if (!as.handle->submit_recvfrom(fd, buf, static_cast<size_t>(len), &ep, id)) {
+            pin_release(as, id);
+            return lua::return_net_error(L, "submit_recvfrom");
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    // submit_sendto(asfd, fd, data, ep, udata[, gso])
+    // Sends data as one datagram to ep, or to the connected peer when ep is
+    // nil.  With gso the kernel cuts data into datagrams of that size.
+    static int async_submit_sendto(lua_State* L) {
+        auto& as          = lua::checkudata<lua_async>(L, 1);
+        net::fd_t fd      = lua_socket::checkfd(L, 2);
+        size_t len        = 0;
+        const char* data  = luaL_checklstring(L, 3, &len);
+        net::endpoint* ep = lua_isnil(L, 4) ? nullptr : &lua::checkudata<net::endpoint>(L, 4);
+        luaL_checkany(L, 5);
+        lua_Integer gso   = luaL_optinteger(L, 6, 0);
+        luaL_argcheck(L, gso >= 0 && gso <= UINT16_MAX, 6, "invalid segment size");
+        // Pin data and ep together until the completion.
+        lua_newuserdatauv(L, 0, 2);
+        lua_pushvalue(L, 3);
+        lua_setiuservalue(L, -2, 1);
+        lua_pushvalue(L, 4);
+        lua_setiuservalue(L, -2, 2);
+        uint64_t id = pin(L, as, lua_gettop(L), 5);
+        lua_pop(L, 1);
+        if (!as.handle->submit_sendto(fd, data, len, ep, static_cast<int>(gso), id)) {
+            pin_release(as, id);
+            return lua::return_net_error(L, "submit_sendto");
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    // bufpool(asfd, bufsize, count) -> pool id
+    static int async_bufpool(lua_State* L) {
+        auto& as            = lua::checkudata<lua_async>(L, 1);
+        lua_Integer bufsize = luaL_checkinteger(L, 2);
+        lua_Integer count   = luaL_checkinteger(L, 3);
+        if (bufsize <= 0) return luaL_error(L, "bufsize must be positive");
+        if (count <= 0 || count > 32768) return luaL_error(L, "count must be in [1, 32768]");
+        // Sizes past size_t saturate so the backend rejects them with ENOMEM.
+        size_t size = static_cast<lua_Unsigned>(bufsize) > SIZE_MAX ? SIZE_MAX : static_cast<size_t>(bufsize);
+        int group   = as.handle->create_buffer_pool(size, static_cast<uint16_t>(count));
+        if (group < 0) {
+            return lua::return_net_error(L, "bufpool");
+        }
+        lua_pushinteger(L, group);
+        return 1;
+    }
+
+    static async::buffer_pool& checkpool(lua_State* L, lua_async& as, int idx, uint16_t& group) {
+        group     = lua::checkinteger<uint16_t>(L, idx);
+        auto pool = as.handle->get_buffer_pool(group);
+        if (!pool) {
+            luaL_error(L, "invalid buffer pool");
+            std::unreachable();
+        }
+        return *pool;
+    }
+
+    static uint16_t checkbid(lua_State* L, async::buffer_pool& pool, int idx) {
+        auto bid = lua::checkinteger<uint16_t>(L, idx);
+        if (!pool.valid(bid)) {
+            luaL_error(L, "invalid buffer id");
+            std::unreachable();
+        }
+        return bid;
+    }
+
+    // Socket, lightuserdata fd or file.
+    static int checkfd_or_file(lua_State* L, int idx) {
+        if (luaL_testudata(L, idx, LUA_FILEHANDLE)) {
+            return tofilefd(L, idx);
+        }
+        return checkfd_any(L, idx);
+    }
+
+    // register_fd(asfd, fd) -> boolean
+    static int async_register_fd(lua_State* L) {
+        auto& as = lua::checkudata<lua_async>(L, 1);
+        int fd   = checkfd_or_file(L, 2);
+        lua_pushboolean(L, as.handle->register_fd(fd) ? 1 : 0);
+        return 1;
+    }
+
+    // unregister_fd(asfd, fd)
+    static int async_unregister_fd(lua_State* L) {
+        auto& as = lua::checkudata<lua_async>(L, 1);
+        int fd   = checkfd_or_file(L, 2);
+        as.handle->unregister_fd(fd);
+        return 0;
+    }
+
+    // submit_recv(asfd, pool, fd, udata)
+    static int async_submit_recv(lua_State* L) {
+        auto& as       = lua::checkudata<lua_async>(L, 1);
+        uint16_t group = 0;
+        checkpool(L, as, 2, group);
+        net::fd_t fd = lua_socket::checkfd(L, 3);
+        luaL_checkany(L, 4);
+        uint64_t id = pin(L, as, 2, 4);
+        if (!as.handle->submit_recv(fd, group, id)) {
+            pin_release(as, id);
+            return lua::return_net_error(L, "submit_recv");
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    // submit_recv_multishot(asfd, pool, fd, udata)
+    // Keeps producing OP_RECV completions until EOF, error or cancel; pool and
+    // udata stay pinned until the final completion.
+    static int async_submit_recv_multishot(lua_State* L) {
+        auto& as       = lua::checkudata<lua_async>(L, 1);
+        uint16_t group = 0;
+        checkpool(L, as, 2, group);
+        net::fd_t fd = lua_socket::checkfd(L, 3);
+        luaL_checkany(L, 4);
+        uint64_t id = pin(L, as, 2, 4);
+        if (!as.handle->submit_recv_multishot(fd, group, id)) {
+            pin_release(as, id);
+            return lua::return_net_error(L, "submit_recv_multishot");
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    // bufpool_read(asfd, pool, bid, n) -> string
+    static int async_bufpool_read(lua_State* L) {
+        auto& as       = lua::checkudata<lua_async>(L, 1);
+        uint16_t group = 0;
+        auto& pool     = checkpool(L, as, 2, group);
+        uint16_t bid   = checkbid(L, pool, 3);
+        lua_Integer n  = luaL_checkinteger(L, 4);
+        if (n < 0 || static_cast<size_t>(n) > pool.buf_size()) return luaL_error(L, "n out of range");
+        lua_pushlstring(L, pool.buffer(bid), static_cast<size_t>(n));
+        return 1;
+    }
+
+    // bufpool_recycle(asfd, pool, bid)
+    static int async_bufpool_recycle(lua_State* L) {
+        auto& as       = lua::checkudata<lua_async>(L, 1);
+        uint16_t group = 0;
+        auto& pool     = checkpool(L, as, 2, group);
+        uint16_t bid   = checkbid(L, pool, 3);
+        if (!as.handle->recycle_buffer(group, bid)) return luaL_error(L, "buffer is not in use");
+        return 0;
+    }
+#endif
+
     static int async_poll(lua_State* L) {
         auto& as = lua::checkudata<lua_async>(L, 1);
         as.i     = 0;
@@ -467,15 +1125,51 @@ namespace bee::lua_async {
         return 1;
     }
 
+    // Wait with the timeout in ms at idx (default -1: no limit).  A
+    // fractional timeout keeps its sub-millisecond part on Linux and is
+    // rounded up elsewhere.
+    static int wait_completions(lua_State* L, lua_async& as, int idx) {
+        auto out = span<async::io_completion>(as.completions.data(), as.completions.size());
+        if (lua_isnoneornil(L, idx) || lua_isinteger(L, idx)) {
+            return as.handle->wait(out, lua::optinteger<int, -1>(L, idx));
+        }
+        lua_Number ms = luaL_checknumber(L, idx);
+        if (!(ms >= 0)) {
+            return as.handle->wait(out, -1);
+        }
+#if defined(__linux__)
+        return as.handle->wait_ns(out, static_cast<int64_t>(std::min<lua_Number>(ms * 1e6, 9e18)));
+#else
+        return as.handle->wait(out, static_cast<int>(std::min<lua_Number>(std::ceil(ms), INT_MAX)));
+#endif
+    }
+
     static int async_wait(lua_State* L) {
-        auto& as    = lua::checkudata<lua_async>(L, 1);
-        int timeout = lua::optinteger<int, -1>(L, 2);
-        as.i        = 0;
-        as.n        = as.handle->wait(span<async::io_completion>(as.completions.data(), as.completions.size()), timeout);
+        auto& as = lua::checkudata<lua_async>(L, 1);
+        as.i     = 0;
+        as.n     = wait_completions(L, as, 2);
         lua_getiuservalue(L, 1, 1);
         return 1;
     }
 
+    // poll_into(asfd, tbl) -> count
+    static int async_poll_into(lua_State* L) {
+        auto& as = lua::checkudata<lua_async>(L, 1);
+        luaL_checktype(L, 2, LUA_TTABLE);
+        as.i = 0;
+        as.n = as.handle->poll(span<async::io_completion>(as.completions.data(), as.completions.size()));
+        return fill_completions(L, as, 2);
+    }
+
+    // wait_into(asfd, tbl, timeout) -> count
+    static int async_wait_into(lua_State* L) {
+        auto& as = lua::checkudata<lua_async>(L, 1);
+        luaL_checktype(L, 2, LUA_TTABLE);
+        as.i = 0;
+        as.n = wait_completions(L, as, 3);
+        return fill_completions(L, as, 2);
+    }
+
     static int async_associate(lua_State* L) {
 #if defined(_WIN32)
         auto& as     = lua::checkudata<lua_async>(L, 1);
@@ -510,15 +1204,167 @@ namespace bee::lua_async {
         return 1;
     }
 
+    // cancel(asfd, fd [, op])
+    // Pending ops complete with status CANCEL; op restricts it to one kind (Linux).
     static int async_cancel(lua_State* L) {
         auto& as     = lua::checkudata<lua_async>(L, 1);
-        net::fd_t fd = lua_socket::checkfd(L, 2);
+        net::fd_t fd = checkfd_any(L, 2);
+#if defined(__linux__)
+        if (!lua_isnoneornil(L, 3)) {
+            auto op = lua::checkinteger<async::async_op>(L, 3);
+            as.handle->cancel(fd, op);
+            return 0;
+        }
+#endif
         as.handle->cancel(fd);
         return 0;
     }
 
+#if defined(__linux__)
+    // ---- mailbox ----
+
+    // Free the payloads of posts in completions[from, as.n) and close the
+    // gap they leave; other completions stay queued for the iterator.
+    static void drop_posts(lua_async& as, int from) {
+        int n = from;
+        for (int k = from; k < as.n; ++k) {
+            if (as.completions[k].op == async::async_op::post) {
+                free(post_payload(as.completions[k]));
+            } else {
+                as.completions[n++] = as.completions[k];
+            }
+        }
+        as.n = n;
+    }
+
+    // Cut the mailbox off from handle, then free the payloads of posts not
+    // yet iterated, pulling pending completions into whatever room is left
+    // in the batch so posts still inside the backend are freed as well.
+    static void mailbox_close(lua_async& as) {
+        if (!as.box) return;
+        {
+            std::unique_lock<std::shared_mutex> lk(as.box->mutex);
+            as.box->handle = nullptr;
+        }
+        g_mailbox.destroy(as.box);
+        as.box.reset();
+        std::copy(as.completions.data() + as.i, as.completions.data() + as.n, as.completions.data());
+        as.n -= as.i;
+        as.i = 0;
+        drop_posts(as, 0);
+        while (static_cast<size_t>(as.n) < as.completions.size()) {
+            int from = as.n;
+            int got  = as.handle->poll(span<async::io_completion>(as.completions.data() + from, as.completions.size() - from));
+            if (got == 0) break;
+            as.n += got;
+            drop_posts(as, from);
+        }
+    }
+
+    // mailbox(asfd, name): let other threads post to this instance under name.
+    static int async_mailbox(lua_State* L) {
+        auto& as  = lua::checkudata<lua_async>(L, 1);
+        auto name = lua::checkstrview(L, 2);
+        if (as.box) {
+            return luaL_error(L, "mailbox is already open");
+        }
+        as.box = g_mailbox.create(name, as.handle.get());
+        if (!as.box) {
+            return luaL_error(L, "Duplicate mailbox '%s'", name.data());
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    // mb:post(value): deliver value to the mailbox owner as an OP_POST completion.
+    static int mailbox_post(lua_State* L) {
+        auto& mb = lua::checkudata<mailbox::box>(L, 1);
+        lua_settop(L, 2);
+        void* data = seri_pack(L, 1, NULL);
+        std::shared_lock<std::shared_mutex> lk(mb->mutex);
+        if (!mb->handle) {
+            free(data);
+            return lua::return_error(L, "mailbox is closed");
+        }
+        if (!mb->handle->post(reinterpret_cast<uintptr_t>(data))) {
+            int err = errno;
+            free(data);
+            return lua::return_net_error(L, "post", err);
+        }
+        lua_pushboolean(L, 1);
+        return 1;
+    }
+
+    // async.mailbox(name): look up a mailbox opened on any thread.
+    static int async_mailbox_query(lua_State* L) {
+        auto name       = lua::checkstrview(L, 1);
+        mailbox::box mb = g_mailbox.query(name);
+        if (!mb) {
+            luaL_pushfail(L);
+            lua_pushfstring(L, "Can't query mailbox '%s'", name.data());
+            return 2;
+        }
+        lua::newudata<mailbox::box>(L, mb);
+        return 1;
+    }
+
+    // stats(asfd): backend counters; ops[OP_*] holds submits, completions
+    // and latency, the log2 histogram with bucket 0 at index 1 and trailing
+    // empty buckets dropped.  Ops never submitted nor completed are absent.
+    static int async_stats(lua_State* L) {
+        auto& as = lua::checkudata<lua_async>(L, 1);
+        async::async_stats st;
+        as.handle->stats(st);
+        lua_createtable(L, 0, 11);
+        auto set = [&](const char* name, uint64_t v) {
+            lua_pushinteger(L, static_cast<lua_Integer>(v));
+            lua_setfield(L, -2, name);
+        };
+        set("submit_failures", st.submit_failures);
+        set("inflight", st.inflight);
+        set("sync_completions", st.sync_completions);
+        set("enter_calls", st.enter_calls);
+        set("cq_overflows", st.cq_overflows);
+        set("wait_calls", st.wait_calls);
+        set("ctl_calls", st.ctl_calls);
+        set("spin_ns", st.spin_ns);
+        set("block_ns", st.block_ns);
+        set("spin_hits", st.spin_hits);
+        lua_newtable(L);
+        for (size_t op = 0; op < async::async_stats::kOps; ++op) {
+            if (st.submits[op] == 0 && st.completions[op] == 0) continue;
+            lua_createtable(L, 0, 3);
+            set("submits", st.submits[op]);
+            set("completions", st.completions[op]);
+            size_t n = async::async_stats::kLatencyBuckets;
+            while (n > 0 && st.latency[op][n - 1] == 0) n--;
+            lua_createtable(L, static_cast<int>(n), 0);
+            for (size_t b = 0; b < n; ++b) {
+                lua_pushinteger(L, static_cast<lua_Integer>(st.latency[op][b]));
+                lua_rawseti(L, -2, static_cast<lua_Integer>(b + 1));
+            }
+            lua_setfield(L, -2, "latency");
+            lua_rawseti(L, -2, static_cast<lua_Integer>(op));
+        }
+        lua_setfield(L, -2, "ops");
+        return 1;
+    }
+#endif
+
+    lua_async::~lua_async() {
+#if defined(__linux__)
+        mailbox_close(*this);
+        // Nothing iterates after this; posts kept by an earlier stop go too.
+        drop_posts(*this, i);
+#endif
+        if (refs) luaref_close(refs);
+    }
+
     static int async_stop(lua_State* L) {
         auto& as = lua::checkudata<lua_async>(L, 1);
+#if defined(__linux__)
+        mailbox_close(as);
+#endif
         as.handle->stop();
         lua_pushboolean(L, 1);
         return 1;
@@ -526,6 +1372,9 @@ namespace bee::lua_async {
 
     static int async_mt_close(lua_State* L) {
         auto& as = lua::checkudata<lua_async>(L, 1);
+#if defined(__linux__)
+        mailbox_close(as);
+#endif
         as.handle->stop();
         return 0;
     }
@@ -577,6 +1426,102 @@ namespace bee::lua_async {
         return 1;
     }
 
+    struct frame_spec {
+        size_t header = 4;  // prefix bytes, 0 = varint
+        bool little   = false;
+        size_t max    = SIZE_MAX;
+    };
+
+    // {header = 1|2|4|8|"varint", endian = "big"|"little", max = n}
+    static frame_spec check_frame_spec(lua_State* L, int idx) {
+        frame_spec spec;
+        if (lua_isnoneornil(L, idx)) return spec;
+        luaL_checktype(L, idx, LUA_TTABLE);
+        switch (lua_getfield(L, idx, "header")) {
+        case LUA_TNIL:
+            break;
+        case LUA_TSTRING:
+            if (strcmp(lua_tostring(L, -1), "varint") != 0) {
+                luaL_error(L, "header must be 1, 2, 4, 8 or 'varint'");
+            }
+            spec.header = 0;
+            break;
+        default: {
+            lua_Integer n = luaL_checkinteger(L, -1);
+            if (n != 1 && n != 2 && n != 4 && n != 8) {
+                luaL_error(L, "header must be 1, 2, 4, 8 or 'varint'");
+            }
+            spec.header = static_cast<size_t>(n);
+            break;
+        }
+        }
+        lua_pop(L, 1);
+        if (LUA_TNIL != lua_getfield(L, idx, "endian")) {
+            static const char* const opts[] = { "big", "little", NULL };
+            spec.little                     = luaL_checkoption(L, -1, NULL, opts) == 1;
+        }
+        lua_pop(L, 1);
+        if (LUA_TNIL != lua_getfield(L, idx, "max")) {
+            lua_Integer n = luaL_checkinteger(L, -1);
+            if (n < 0) luaL_error(L, "max must not be negative");
+            spec.max = static_cast<size_t>(n);
+        }
+        lua_pop(L, 1);
+        return spec;
+    }
+
+    // Push the body of the frame at head, copied once out of the ring.
+    // Returns false (pushing nothing) if the frame is incomplete, or
+    // sets err for a frame that can never be read.
+    static bool push_frame(lua_State* L, async::read_buf& rb, const frame_spec& spec, const char*& err) {
+        size_t hdr, len;
+        switch (rb.frame(spec.header, spec.little, spec.max, hdr, len)) {
+        case async::read_buf::frame_status::complete:
+            break;
+        case async::read_buf::frame_status::partial:
+            return false;
+        case async::read_buf::frame_status::too_large:
+            err = "frame too large";
+            return false;
+        case async::read_buf::frame_status::bad_header:
+            err = "bad frame header";
+            return false;
+        }
+        rb.skip(hdr);
+        luaL_Buffer b;
+        char* dst = luaL_buffinitsize(L, &b, len);
+        rb.consume(dst, len);
+        luaL_pushresultsize(&b, len);
+        return true;
+    }
+
+    static int rb_read_frame(lua_State* L) {
+        auto& rb        = lua::checkudata<async::read_buf>(L, 1);
+        frame_spec spec = check_frame_spec(L, 2);
+        const char* err = nullptr;
+        if (push_frame(L, rb, spec, err)) return 1;
+        if (err) return lua::return_error(L, err);
+        lua_pushnil(L);
+        return 1;
+    }
+
+    // read_frames(rb, spec) -> {frame...}[, err]: every complete frame buffered.
+    static int rb_read_frames(lua_State* L) {
+        auto& rb        = lua::checkudata<async::read_buf>(L, 1);
+        frame_spec spec = check_frame_spec(L, 2);
+        const char* err = nullptr;
+        lua_newtable(L);
+        lua_Integer n = 0;
+        while (push_frame(L, rb, spec, err)) {
+            lua_rawseti(L, -2, ++n);
+        }
+        if (err) {
+            lua_pushstring(L, err);
+            return 2;
+        }
+        return 1;
+    }
+
     static int async_readbuf_create(lua_State* L) {
         lua_Integer bufsize = luaL_checkinteger(L, 1);
         if (bufsize <= 0) return luaL_error(L, "bufsize must be positive");
@@ -635,11 +1580,36 @@ namespace bee::lua_async {
             { "submit_file_read", async_submit_file_read },
             { "submit_file_write", async_submit_file_write },
             { "submit_poll", async_submit_poll },
+#if defined(__linux__)
+            { "submit_accept_multishot", async_submit_accept_multishot },
+            { "submit_recv", async_submit_recv },
+            { "submit_recv_multishot", async_submit_recv_multishot },
+            { "submit_timer", async_submit_timer },
+            { "submit_file_open", async_submit_file_open },
+            { "submit_file_close", async_submit_file_close },
+            { "submit_fsync", async_submit_fsync },
+            { "submit_fdatasync", async_submit_fdatasync },
+            { "submit_statx", async_submit_statx },
+            { "submit_sendfile", async_submit_sendfile },
+            { "submit_relay", async_submit_relay },
+            { "submit_recvfrom", async_submit_recvfrom },
+            { "submit_sendto", async_submit_sendto },
+            { "bufpool", async_bufpool },
+            { "bufpool_read", async_bufpool_read },
+            { "bufpool_recycle", async_bufpool_recycle },
+            { "mailbox", async_mailbox },
+            { "register_fd", async_register_fd },
+            { "unregister_fd", async_unregister_fd },
+            { "cancel_timer", async_cancel_timer },
+            { "stats", async_stats },
+#endif
             { "associate", async_associate },
             { "associate_file", async_associate_file },
             { "cancel", async_cancel },
             { "poll", async_poll },
             { "wait", async_wait },
+            { "poll_into", async_poll_into },
+            { "wait_into", async_wait_into },
             { "stop", async_stop },
             { NULL, NULL }
         };
@@ -653,11 +1623,51 @@ namespace bee::lua_async {
         luaL_setfuncs(L, mt, 0);
     }
 
+    static uint32_t opt_uint32_field(lua_State* L, int idx, const char* name) {
+        uint32_t v = 0;
+        if (LUA_TNIL != lua_getfield(L, idx, name)) {
+            lua_Integer n = luaL_checkinteger(L, -1);
+            if (n < 0 || n > UINT32_MAX)
+                luaL_error(L, "%s is out of range", name);
+            v = static_cast<uint32_t>(n);
+        }
+        lua_pop(L, 1);
+        return v;
+    }
+
+    static bool opt_bool_field(lua_State* L, int idx, const char* name) {
+        lua_getfield(L, idx, name);
+        bool v = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+        return v;
+    }
+
     static int async_create(lua_State* L) {
-        lua_Integer max_completions = luaL_optinteger(L, 1, 64);
+        lua_Integer max_completions = 64;
+        async::async_options options;
+        if (lua_type(L, 1) == LUA_TTABLE) {
+            if (LUA_TNIL != lua_getfield(L, 1, "max_completions")) {
+                max_completions = luaL_checkinteger(L, -1);
+            }
+            lua_pop(L, 1);
+            options.entries            = opt_uint32_field(L, 1, "entries");
+            options.cq_entries         = opt_uint32_field(L, 1, "cq_entries");
+            options.sqpoll             = opt_bool_field(L, 1, "sqpoll");
+            options.sqpoll_idle        = opt_uint32_field(L, 1, "sqpoll_idle");
+            options.coop_taskrun       = opt_bool_field(L, 1, "coop_taskrun");
+            options.defer_taskrun      = opt_bool_field(L, 1, "defer_taskrun");
+            options.single_issuer      = opt_bool_field(L, 1, "single_issuer");
+            options.files              = opt_uint32_field(L, 1, "files");
+            options.zerocopy_threshold = opt_uint32_field(L, 1, "zerocopy_threshold");
+            options.file_threads       = opt_uint32_field(L, 1, "file_threads");
+            options.edge_triggered     = opt_bool_field(L, 1, "edge_triggered");
+            options.busy_poll          = opt_uint32_field(L, 1, "busy_poll");
+        } else {
+            max_completions = luaL_optinteger(L, 1, 64);
+        }
         if (max_completions <= 0)
             return lua::return_error(L, "max_completions is less than or equal to zero.");
-        auto handle = async::create();
+        auto handle = async::create(options);
         if (!handle)
             return lua::return_error(L, "failed to create async backend");
         lua::newudata<lua_async>(L, static_cast<size_t>(max_completions));
@@ -675,6 +1685,9 @@ namespace bee::lua_async {
             { "create", async_create },
             { "readbuf", async_readbuf_create },
             { "writebuf", async_writebuf_create },
+#if defined(__linux__)
+            { "mailbox", async_mailbox_query },
+#endif
             { NULL, NULL },
         };
         luaL_newlib(L, l);
@@ -687,6 +1700,7 @@ namespace bee::lua_async {
         SETENUM(CLOSE, async::async_status::close);
         SETENUM(ERROR, async::async_status::error);
         SETENUM(CANCEL, async::async_status::cancel);
+        SETENUM(TIMEOUT, async::async_status::timeout);
 
         SETENUM(OP_READ, async::async_op::read);
         SETENUM(OP_WRITE, async::async_op::write);
@@ -695,6 +1709,17 @@ namespace bee::lua_async {
         SETENUM(OP_FILE_READ, async::async_op::file_read);
         SETENUM(OP_FILE_WRITE, async::async_op::file_write);
         SETENUM(OP_POLL, async::async_op::fd_poll);
+        SETENUM(OP_RECV, async::async_op::recv);
+        SETENUM(OP_TIMER, async::async_op::timer);
+        SETENUM(OP_FILE_OPEN, async::async_op::file_open);
+        SETENUM(OP_FILE_CLOSE, async::async_op::file_close);
+        SETENUM(OP_FSYNC, async::async_op::file_fsync);
+        SETENUM(OP_STATX, async::async_op::file_statx);
+        SETENUM(OP_SENDFILE, async::async_op::sendfile);
+        SETENUM(OP_RELAY, async::async_op::relay);
+        SETENUM(OP_RECVFROM, async::async_op::recvfrom);
+        SETENUM(OP_SENDTO, async::async_op::sendto);
+        SETENUM(OP_POST, async::async_op::post);
 #undef SETENUM
         return 1;
     }
@@ -708,12 +1733,28 @@ namespace bee::lua {
         static inline int nupvalue   = 1;
         static inline auto metatable = bee::lua_async::metatable;
     };
+#if defined(__linux__)
+    template <>
+    struct udata<lua_async::mailbox::box> {
+        static inline auto metatable = [](lua_State* L) {
+            static luaL_Reg lib[] = {
+                { "post", lua_async::mailbox_post },
+                { NULL, NULL }
+            };
+            luaL_newlibtable(L, lib);
+            luaL_setfuncs(L, lib, 0);
+            lua_setfield(L, -2, "__index");
+        };
+    };
+#endif
     template <>
     struct udata<async::read_buf> {
         static inline auto metatable = [](lua_State* L) {
             static luaL_Reg lib[] = {
                 { "read", lua_async::rb_read },
                 { "readline", lua_async::rb_readline },
+                { "read_frame", lua_async::rb_read_frame },
+                { "read_frames", lua_async::rb_read_frames },
                 { NULL, NULL }
             };
             luaL_newlibtable(L, lib);
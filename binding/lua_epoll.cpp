@@ -5,8 +5,12 @@
 #include <bee/lua/udata.h>
 #include <bee/net/bpoll.h>
 #include <bee/nonstd/to_underlying.h>
+#include <bee/utility/busy_poll.h>
 #include <bee/utility/dynarray.h>
 
+#include <algorithm>
+#include <cstdint>
+
 namespace bee::lua_epoll {
     struct lua_epoll {
         net::bpoll_handle fd;
@@ -14,10 +18,12 @@ namespace bee::lua_epoll {
         int n = 0;
         luaref ref;
         dynarray<net::bpoll_event_t> events;
-        lua_epoll(lua_State *L, net::bpoll_handle epfd, size_t max_events)
+        busy_poll spin;
+        lua_epoll(lua_State *L, net::bpoll_handle epfd, size_t max_events, int64_t busy_poll_ns)
             : fd(epfd)
             , ref(luaref_init(L))
-            , events(max_events) {
+            , events(max_events)
+            , spin(busy_poll_ns) {
         }
         ~lua_epoll() {
             close();
@@ -61,8 +67,20 @@ namespace bee::lua_epoll {
         if (ep.fd == net::invalid_bpoll_handle) {
             return lua::return_error(L, "bad file descriptor");
         }
-        int timeout = lua::optinteger<int, -1>(L, 2);
-        int n       = net::bpoll_wait(ep.fd, ep.events, timeout);
+        // Fractional milliseconds are kept as nanoseconds for bpoll_wait_ns.
+        int64_t timeout_ns = -1;
+        if (lua_isinteger(L, 2)) {
+            lua_Integer ms = lua_tointeger(L, 2);
+            timeout_ns     = ms < 0 ? -1 : static_cast<int64_t>(std::min<lua_Integer>(ms, INT64_MAX / 1000000)) * 1000000;
+        } else if (!lua_isnoneornil(L, 2)) {
+            lua_Number ms = luaL_checknumber(L, 2);
+            timeout_ns    = ms >= 0 ? static_cast<int64_t>(std::min<lua_Number>(ms * 1e6, 9e18)) : -1;
+        }
+        int n = ep.spin.wait(
+            timeout_ns,
+            [&] { return net::bpoll_wait(ep.fd, ep.events, 0); },
+            [&](int64_t rest) { return net::bpoll_wait_ns(ep.fd, ep.events, rest); }
+        );
         if (n == -1) {
             return lua::return_net_error(L, "epoll_wait");
         }
@@ -215,11 +233,15 @@ namespace bee::lua_epoll {
         if (max_events <= 0) {
             return lua::return_error(L, "maxevents is less than or equal to zero.");
         }
+        lua_Integer busy_poll_us = luaL_optinteger(L, 2, 0);
+        if (busy_poll_us < 0 || busy_poll_us > UINT32_MAX) {
+            return lua::return_error(L, "busy_poll is out of range.");
+        }
         net::bpoll_handle epfd = net::bpoll_create();
         if (epfd == (net::bpoll_handle)-1) {
             return lua::return_net_error(L, "epoll_create");
         }
-        lua::newudata<lua_epoll>(L, L, epfd, (size_t)max_events);
+        lua::newudata<lua_epoll>(L, L, epfd, (size_t)max_events, busy_poll_us * 1000);
         lua_newtable(L);
         lua_setiuservalue(L, -2, 1);
         lua_pushvalue(L, -1);
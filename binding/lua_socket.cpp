@@ -7,6 +7,8 @@
 #include <bee/nonstd/unreachable.h>
 #include <bee/utility/hybrid_array.h>
 
+#include <cstdint>
+
 namespace bee::lua_socket {
 #if LUA_VERSION_NUM >= 505
     struct luabuf {
@@ -269,12 +271,16 @@ namespace bee::lua_socket {
             auto len = lua::optinteger<int, LUAL_BUFFERSIZE>(L, 2);
             auto& ep = lua::newudata<net::endpoint>(L);
             luabuf b(L, (size_t)len);
-            char* buf = b.buf;
-            int rc;
-            switch (net::socket::recvfrom(fd, rc, ep, buf, len)) {
+            net::socket::datagram msg { b.buf, len, &ep };
+            int n;
+            switch (net::socket::recvmmsg(fd, n, span<net::socket::datagram>(&msg, 1))) {
             case net::socket::status::success:
-                b.pushresultsize(L, rc);
+                b.pushresultsize(L, msg.len);
                 lua_insert(L, -2);
+                if (msg.segsize > 0) {
+                    lua_pushinteger(L, msg.segsize);
+                    return 3;
+                }
                 return 2;
             case net::socket::status::wait:
                 lua_pushboolean(L, 0);
@@ -303,6 +309,106 @@ namespace bee::lua_socket {
                 std::unreachable();
             }
         }
+        // Receive area of recvmmsg, kept in the registry and only replaced
+        // when a call needs more, so steady-state calls do not allocate.
+        static int RECVMMSG_SCRATCH;
+        static char* recvmmsg_scratch(lua_State* L, size_t size) {
+            if (lua_rawgetp(L, LUA_REGISTRYINDEX, &RECVMMSG_SCRATCH) == LUA_TUSERDATA && lua_rawlen(L, -1) >= size) {
+                char* buf = static_cast<char*>(lua_touserdata(L, -1));
+                lua_pop(L, 1);
+                return buf;
+            }
+            lua_pop(L, 1);
+            char* buf = static_cast<char*>(lua_newuserdatauv(L, size, 0));
+            lua_rawsetp(L, LUA_REGISTRYINDEX, &RECVMMSG_SCRATCH);
+            return buf;
+        }
+        // recvmmsg(msgs, eps[, size[, segs]]): receive up to #eps datagrams,
+        // storing the data in msgs[i] and overwriting the endpoint eps[i] in
+        // place; segs[i] gets the GRO segment size (0 if not coalesced).
+        static int recvmmsg(lua_State* L, net::fd_t fd) {
+            luaL_checktype(L, 2, LUA_TTABLE);
+            luaL_checktype(L, 3, LUA_TTABLE);
+            auto len   = lua::optinteger<int, LUAL_BUFFERSIZE>(L, 4);
+            auto count = static_cast<size_t>(luaL_len(L, 3));
+            luaL_argcheck(L, len > 0, 4, "buffer size must be positive");
+            luaL_argcheck(L, count > 0, 3, "endpoint array is empty");
+            bool has_segs = !lua_isnoneornil(L, 5);
+            if (has_segs) luaL_checktype(L, 5, LUA_TTABLE);
+            luaL_argcheck(L, count <= SIZE_MAX / (size_t)len, 4, "buffer size too large");
+            char* buf = recvmmsg_scratch(L, count * (size_t)len);
+            hybrid_array<net::socket::datagram, 32> msgs(count);
+            for (size_t i = 0; i < count; ++i) {
+                lua_rawgeti(L, 3, (lua_Integer)i + 1);
+                msgs[i].buf     = buf + i * (size_t)len;
+                msgs[i].len     = len;
+                msgs[i].ep      = &lua::checkudata<net::endpoint>(L, -1);
+                msgs[i].segsize = 0;
+                lua_pop(L, 1);
+            }
+            int n;
+            switch (net::socket::recvmmsg(fd, n, span<net::socket::datagram>(msgs.data(), count))) {
+            case net::socket::status::success:
+                for (int i = 0; i < n; ++i) {
+                    lua_pushlstring(L, msgs[i].buf, (size_t)msgs[i].len);
+                    lua_rawseti(L, 2, i + 1);
+                    if (has_segs) {
+                        lua_pushinteger(L, msgs[i].segsize);
+                        lua_rawseti(L, 5, i + 1);
+                    }
+                }
+                lua_pushinteger(L, n);
+                return 1;
+            case net::socket::status::wait:
+                lua_pushboolean(L, 0);
+                return 1;
+            case net::socket::status::failed:
+                return lua::return_net_error(L, "recvmmsg");
+            default:
+                std::unreachable();
+            }
+        }
+        // sendmmsg(msgs, eps[, n]): send msgs[1..n] to eps[1..n] (eps = nil
+        // on a connected socket); returns how many were sent.
+        static int sendmmsg(lua_State* L, net::fd_t fd) {
+            luaL_checktype(L, 2, LUA_TTABLE);
+            bool has_ep = !lua_isnoneornil(L, 3);
+            if (has_ep) luaL_checktype(L, 3, LUA_TTABLE);
+            auto count = lua::optinteger<lua_Integer, 0>(L, 4);
+            if (count == 0) count = luaL_len(L, 2);
+            luaL_argcheck(L, count > 0, 4, "nothing to send");
+            hybrid_array<net::socket::datagram, 32> msgs((size_t)count);
+            for (lua_Integer i = 0; i < count; ++i) {
+                size_t sz;
+                // Only a real string is kept alive by the msgs table; a number
+                // would be converted into a temporary string popped below.
+                if (lua_rawgeti(L, 2, i + 1) != LUA_TSTRING) return luaL_error(L, "msgs[%d] is not a string", (int)i + 1);
+                const char* data = lua_tolstring(L, -1, &sz);
+                lua_pop(L, 1);
+                msgs[i].buf     = const_cast<char*>(data);
+                msgs[i].len     = (int)sz;
+                msgs[i].ep      = nullptr;
+                msgs[i].segsize = 0;
+                if (has_ep) {
+                    lua_rawgeti(L, 3, i + 1);
+                    msgs[i].ep = &lua::checkudata<net::endpoint>(L, -1);
+                    lua_pop(L, 1);
+                }
+            }
+            int n;
+            switch (net::socket::sendmmsg(fd, n, span<const net::socket::datagram>(msgs.data(), (size_t)count))) {
+            case net::socket::status::success:
+                lua_pushinteger(L, n);
+                return 1;
+            case net::socket::status::wait:
+                lua_pushboolean(L, 0);
+                return 1;
+            case net::socket::status::failed:
+                return lua::return_net_error(L, "sendmmsg");
+            default:
+                std::unreachable();
+            }
+        }
         static int shutdown(lua_State* L, net::fd_t fd, net::socket::shutdown_flag flag) {
             if (!net::socket::shutdown(fd, flag)) {
                 return lua::return_net_error(L, "shutdown");
@@ -353,7 +459,7 @@ namespace bee::lua_socket {
             return 0;
         }
         static int option(lua_State* L, net::fd_t fd) {
-            static const char* const opts[] = { "reuseaddr", "sndbuf", "rcvbuf", "nodelay", NULL };
+            static const char* const opts[] = { "reuseaddr", "sndbuf", "rcvbuf", "nodelay", "udp_segment", "udp_gro", "busy_poll", NULL };
             auto opt                        = (net::socket::option)luaL_checkoption(L, 2, NULL, opts);
             auto value                      = lua::checkinteger<int>(L, 3);
             bool ok                         = net::socket::setoption(fd, opt, value);
@@ -442,6 +548,8 @@ namespace bee::lua_socket {
                 { "sendv", call_socket<sendv> },
                 { "recvfrom", call_socket<recvfrom> },
                 { "sendto", call_socket<sendto> },
+                { "recvmmsg", call_socket<recvmmsg> },
+                { "sendmmsg", call_socket<sendmmsg> },
                 { "shutdown", call_socket<shutdown> },
                 { "status", call_socket<status> },
                 { "info", call_socket<info> },
@@ -473,6 +581,8 @@ namespace bee::lua_socket {
                 { "sendv", call_socket<sendv, fd_no_ownership> },
                 { "recvfrom", call_socket<recvfrom, fd_no_ownership> },
                 { "sendto", call_socket<sendto, fd_no_ownership> },
+                { "recvmmsg", call_socket<recvmmsg, fd_no_ownership> },
+                { "sendmmsg", call_socket<sendmmsg, fd_no_ownership> },
                 { "shutdown", call_socket<shutdown, fd_no_ownership> },
                 { "status", call_socket<status, fd_no_ownership> },
                 { "info", call_socket<info, fd_no_ownership> },
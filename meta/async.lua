@@ -7,6 +7,7 @@
 ---@field CLOSE integer 连接关闭
 ---@field ERROR integer 操作错误
 ---@field CANCEL integer 操作取消
+---@field TIMEOUT integer 操作超过 deadline 被取消（仅 Linux）
 ---@field OP_READ integer 流式读操作
 ---@field OP_WRITE integer writebuf 写操作
 ---@field OP_ACCEPT integer accept 操作
@@ -14,6 +15,17 @@
 ---@field OP_FILE_READ integer 文件读操作
 ---@field OP_FILE_WRITE integer 文件写操作
 ---@field OP_POLL integer poll 操作
+---@field OP_RECV integer buffer-select 接收操作（仅 Linux）
+---@field OP_TIMER integer 定时器（仅 Linux）
+---@field OP_FILE_OPEN integer 文件打开操作（仅 Linux）
+---@field OP_FILE_CLOSE integer 文件关闭操作（仅 Linux）
+---@field OP_FSYNC integer fsync/fdatasync 操作（仅 Linux）
+---@field OP_STATX integer statx 操作（仅 Linux）
+---@field OP_SENDFILE integer sendfile 操作（仅 Linux）
+---@field OP_RELAY integer relay 操作（仅 Linux）
+---@field OP_RECVFROM integer recvfrom 操作（仅 Linux）
+---@field OP_SENDTO integer sendto 操作（仅 Linux）
+---@field OP_POST integer mailbox 投递（仅 Linux）
 local async = {}
 
 ---异步I/O实例对象
@@ -29,9 +41,10 @@ local asfd = {}
 ---@param rb bee.async.readbuf 接收缓冲区对象
 ---@param fd bee.socket.fd socket 对象
 ---@param udata any 用户自定义数据，completion 时原样返回
+---@param deadline? integer 超时毫秒数（仅 Linux），超时未完成则以 TIMEOUT 状态完成
 ---@return boolean? # 成功投递返回true，背压返回false，系统调用失败返回nil
 ---@return string? # 系统调用失败时的错误消息
-function asfd:submit_read(rb, fd, udata)
+function asfd:submit_read(rb, fd, udata, deadline)
 end
 
 ---提交 writebuf 异步写操作
@@ -41,17 +54,30 @@ end
 ---@param wb bee.async.writebuf 写缓冲区对象
 ---@param fd bee.socket.fd socket 对象
 ---@param udata any 用户自定义数据，队列清空时作为 completion 的 udata 返回
+---@param deadline? integer 整个队列写完的超时毫秒数（仅 Linux），超时则以 TIMEOUT 状态完成
 ---@return boolean? # 成功返回true，失败返回nil
 ---@return string? # 错误消息
-function asfd:submit_write(wb, fd, udata)
+function asfd:submit_write(wb, fd, udata, deadline)
 end
 
 ---提交异步accept操作
 ---@param listen_fd bee.socket.fd 监听 socket 对象
 ---@param udata any 用户自定义数据，completion 时原样返回
+---@param deadline? integer 超时毫秒数（仅 Linux），超时未完成则以 TIMEOUT 状态完成
 ---@return boolean? # 成功返回true，失败返回nil
 ---@return string? # 错误消息
-function asfd:submit_accept(listen_fd, udata)
+function asfd:submit_accept(listen_fd, udata, deadline)
+end
+
+---提交 multishot accept 操作（仅 Linux）
+---一次提交持续产生 completion：每接受一个连接产生一次 OP_ACCEPT completion，
+---直到出错或被取消为止。io_uring 下使用 IORING_ACCEPT_MULTISHOT，
+---epoll 下在每次可读事件中循环 accept 直到 EAGAIN。
+---@param listen_fd bee.socket.fd 监听 socket 对象
+---@param udata any 用户自定义数据，每次 completion 时原样返回
+---@return boolean? # 成功返回true，失败返回nil
+---@return string? # 错误消息
+function asfd:submit_accept_multishot(listen_fd, udata)
 end
 
 ---提交异步connect操作
@@ -59,10 +85,11 @@ end
 ---@param host string 目标主机名或IP地址
 ---@param port integer 目标端口号
 ---@param udata any 用户自定义数据，completion 时原样返回
+---@param deadline? integer 超时毫秒数（仅 Linux），超时未完成则以 TIMEOUT 状态完成
 ---@return boolean? # 成功返回true，失败返回nil
 ---@return string? # 错误消息
----@overload fun(self: bee.async.fd, fd: bee.socket.fd, ep: bee.socket.endpoint, udata: any): boolean?, string?
-function asfd:submit_connect(fd, host, port, udata)
+---@overload fun(self: bee.async.fd, fd: bee.socket.fd, ep: bee.socket.endpoint, udata: any, deadline?: integer): boolean?, string?
+function asfd:submit_connect(fd, host, port, udata, deadline)
 end
 
 ---将文件关联到当前异步I/O实例（仅 Windows/IOCP）
@@ -104,6 +131,189 @@ end
 function asfd:submit_poll(fd, udata)
 end
 
+---创建共享接收缓冲池（buffer-select 模式，仅 Linux）
+---io_uring 下注册为内核 provided-buffer ring，epoll 下由用户态空闲链表模拟。
+---缓冲区只在数据真正到达时才被挑选，空闲连接不占用缓冲区。
+---@param bufsize integer 每个缓冲区的字节数
+---@param count integer 缓冲区数量，范围 [1, 32768]
+---@return integer? # 缓冲池 id，失败返回nil（总大小过大或内存不足时为 ENOMEM）
+---@return string? # 错误消息
+function asfd:bufpool(bufsize, count)
+end
+
+---提交 buffer-select 接收操作（仅 Linux）
+---completion 的 op 为 OP_RECV；成功时第六个返回值为存放数据的缓冲区 id，
+---调用方读取后必须通过 bufpool_recycle 归还。失败或关闭时不返回缓冲区 id。
+---缓冲池耗尽时 completion 以 ERROR（ENOBUFS）结束。
+---@param pool integer 缓冲池 id
+---@param fd bee.socket.fd socket 对象
+---@param udata any 用户自定义数据，completion 时原样返回
+---@return boolean? # 成功返回true，失败返回nil
+---@return string? # 错误消息
+function asfd:submit_recv(pool, fd, udata)
+end
+
+---提交 multishot buffer-select 接收操作（仅 Linux）
+---一次提交持续产生 OP_RECV completion，直到对端关闭、出错（包括缓冲池耗尽）或被取消。
+---io_uring 下使用 IORING_RECV_MULTISHOT，epoll 下保持 EPOLLIN 注册直到结束。
+---每次成功的 completion 都携带缓冲区 id，调用方读取后必须归还。
+---@param pool integer 缓冲池 id
+---@param fd bee.socket.fd socket 对象
+---@param udata any 用户自定义数据，每次 completion 时原样返回
+---@return boolean? # 成功返回true，失败返回nil
+---@return string? # 错误消息
+function asfd:submit_recv_multishot(pool, fd, udata)
+end
+
+---提交定时器（仅 Linux）
+---ms 毫秒后产生一次 op 为 OP_TIMER、状态为 SUCCESS 的 completion，
+---与 I/O completion 从同一个迭代器返回。io_uring 下使用 IORING_OP_TIMEOUT，
+---epoll 下使用内部最小堆，wait 不会睡过最近的定时器。
+---@param ms integer 毫秒数
+---@param udata any 用户自定义数据，completion 时原样返回
+---@return integer? # 成功返回定时器 id，用于 cancel_timer；失败返回nil
+---@return string? # 错误消息
+function asfd:submit_timer(ms, udata)
+end
+
+---提交异步打开文件操作（仅 Linux）
+---io_uring 下使用 IORING_OP_OPENAT，epoll 下在当前线程执行。
+---completion 的 op 为 OP_FILE_OPEN，成功时第四个返回值为文件对象，
+---可用于 submit_file_read/submit_file_write 等操作。
+---@param path string 文件路径
+---@param mode? string 与 io.open 相同的打开模式（"r"、"w"、"a"，可加 "+"），默认 "r"
+---@param udata any 用户自定义数据，completion 时原样返回
+---@return boolean? # 成功返回true，失败返回nil
+---@return string? # 错误消息
+function asfd:submit_file_open(path, mode, udata)
+end
+
+---提交异步关闭文件操作（仅 Linux）
+---文件对象立即变为已关闭状态，底层文件的最终关闭异步完成，completion 的 op 为 OP_FILE_CLOSE。
+---仅支持 io.open 或 submit_file_open 得到的文件。
+---@param file file* 文件对象
+---@param udata any 用户自定义数据，completion 时原样返回
+---@return boolean? # 成功返回true，失败返回nil
+---@return string? # 错误消息
+function asfd:submit_file_close(file, udata)
+end
+
+---提交异步 fsync 操作（仅 Linux）
+---提交前先刷新文件对象的缓冲区，completion 的 op 为 OP_FSYNC。
+---@param file file* 文件对象
+---@param udata any 用户自定义数据，completion 时原样返回
+---@return boolean? # 成功返回true，失败返回nil
+---@return string? # 错误消息
+function asfd:submit_fsync(file, udata)
+end
+
+---提交异步 fdatasync 操作（仅 Linux）
+---与 submit_fsync 相同，但不同步与读取数据无关的元数据，completion 的 op 为 OP_FSYNC。
+---@param file file* 文件对象
+---@param udata any 用户自定义数据，completion 时原样返回
+---@return boolean? # 成功返回true，失败返回nil
+---@return string? # 错误消息
+function asfd:submit_fdatasync(file, udata)
+end
+
+---提交异步 statx 操作（仅 Linux）
+---completion 的 op 为 OP_STATX，成功时第四个返回值为 bee.async.statx 表。
+---@param file string|file* 文件路径或文件对象
+---@param udata any 用户自定义数据，completion 时原样返回
+---@return boolean? # 成功返回true，失败返回nil
+---@return string? # 错误消息
+function asfd:submit_statx(file, udata)
+end
+
+---提交异步 sendfile 操作：把文件内容直接发送到 socket，不经过 Lua（仅 Linux）
+---只产生一个 completion，op 为 OP_SENDFILE，第四个返回值为实际发送的字节数；
+---遇到文件末尾时可能少于 len。
+---@param fd bee.socket.fd socket 对象
+---@param file file* 文件对象，completion 返回前保持引用
+---@param offset integer? 文件偏移，默认 0
+---@param len integer? 发送字节数，默认发送到文件末尾
+---@param udata any 用户自定义数据，completion 时原样返回
+---@return boolean? # 成功返回true，失败返回nil
+---@return string? # 错误消息
+function asfd:submit_sendfile(fd, file, offset, len, udata)
+end
+
+---提交异步 relay 操作：在内核中把 src 收到的数据转发到 dst（仅 Linux）
+---持续转发直到 src 遇到 EOF 或达到 opts.limit 字节，只产生一个 completion，
+---op 为 OP_RELAY，第四个返回值为转发的总字节数。
+---同一对 socket 可以同时提交两个方向的 relay。
+---@param src bee.socket.fd 数据来源 socket
+---@param dst bee.socket.fd 数据目标 socket
+---@param opts { limit: integer? }? 选项，limit 为最多转发的字节数
+---@param udata any 用户自定义数据，completion 时原样返回
+---@return boolean? # 成功返回true，失败返回nil
+---@return string? # 错误消息
+function asfd:submit_relay(src, dst, opts, udata)
+end
+
+---提交异步 UDP 接收操作：接收一个数据报（仅 Linux）
+---发送方地址写入 ep，completion 的 op 为 OP_RECVFROM，第四个返回值为数据报内容。
+---socket 开启 udp_gro 且数据被合并时，第六个返回值为分段大小。
+---ep 在 completion 返回前不应被复用。
+---@param fd bee.socket.fd UDP socket
+---@param ep bee.endpoint 预先分配的端点，用于接收发送方地址
+---@param size integer 数据报的最大长度，超出部分被截断
+---@param udata any 用户自定义数据，completion 时原样返回
+---@return boolean? # 成功返回true，失败返回nil
+---@return string? # 错误消息
+function asfd:submit_recvfrom(fd, ep, size, udata)
+end
+
+---提交异步 UDP 发送操作：把 data 作为一个数据报发送到 ep（仅 Linux）
+---ep 为 nil 时发送给已 connect 的对端。completion 的 op 为 OP_SENDTO。
+---指定 gso 时由内核把 data 按 gso 字节切分为多个数据报（UDP GSO）。
+---@param fd bee.socket.fd UDP socket
+---@param data string 数据报内容
+---@param ep bee.endpoint? 目标端点
+---@param udata any 用户自定义数据，completion 时原样返回
+---@param gso? integer 分段大小
+---@return boolean? # 成功返回true，失败返回nil
+---@return string? # 错误消息
+function asfd:submit_sendto(fd, data, ep, udata, gso)
+end
+
+---取消定时器（仅 Linux）
+---尚未触发的定时器以 CANCEL 状态完成；已触发的定时器不受影响。
+---id 不会被复用，对已完成的定时器调用 cancel_timer 不产生任何效果。
+---@param id integer submit_timer 返回的定时器 id
+function asfd:cancel_timer(id)
+end
+
+---从缓冲池的指定缓冲区复制数据（不归还缓冲区，仅 Linux）
+---@param pool integer 缓冲池 id
+---@param bid integer 缓冲区 id
+---@param n integer 读取字节数
+---@return string
+function asfd:bufpool_read(pool, bid, n)
+end
+
+---将缓冲区归还给缓冲池（仅 Linux）
+---只能归还由 completion 交出且尚未归还的缓冲区，否则抛出错误。
+---@param pool integer 缓冲池 id
+---@param bid integer 缓冲区 id
+function asfd:bufpool_recycle(pool, bid)
+end
+
+---将 fd 注册到 io_uring 固定文件表（仅 Linux）
+---注册后针对该 fd 的操作使用 IOSQE_FIXED_FILE，省去每次操作的文件引用计数开销。
+---固定文件表持有文件引用：关闭 fd 前必须先调用 unregister_fd，否则连接不会真正关闭。
+---accept 得到的 socket 需要时由调用方自行注册。
+---表已满或内核不支持时返回 false，此时操作仍使用普通 fd。epoll 下为空操作。
+---@param fd bee.socket.fd|lightuserdata|file* socket 对象、fd 或文件
+---@return boolean # 是否已注册
+function asfd:register_fd(fd)
+end
+
+---从固定文件表移除 fd（仅 Linux）
+---@param fd bee.socket.fd|lightuserdata|file* socket 对象、fd 或文件
+function asfd:unregister_fd(fd)
+end
+
 ---将 socket 关联到当前异步I/O实例（仅 Windows/IOCP）
 ---必须在首次提交任何 I/O 操作之前调用
 ---@param fd bee.socket.fd socket 对象
@@ -111,30 +321,103 @@ end
 function asfd:associate(fd)
 end
 
----取消指定 socket 上的所有待处理 I/O 操作（仅 Windows/IOCP）
----通常在关闭 socket 前调用，以确保所有 overlapped 操作及时完成
----@param fd bee.socket.fd socket 对象
-function asfd:cancel(fd)
+---取消指定 socket 上的待处理 I/O 操作
+---Linux 下被取消的操作以 CANCEL 状态完成（io_uring 使用 IORING_OP_ASYNC_CANCEL），
+---取消后连接仍可继续使用；Windows 下操作以错误完成，通常在关闭 socket 前调用。
+---epoll 的 edge_triggered 模式下还会撤销 fd 的 epoll 注册。
+---@param fd bee.socket.fd socket 对象（或 channel:fd() 返回的 fd）
+---@param op? integer 只取消该类型的操作（OP_READ、OP_ACCEPT 等，仅 Linux），nil 表示全部
+function asfd:cancel(fd, op)
 end
 
 ---轮询已完成的I/O事件（非阻塞）
 ---accept 操作完成时第四个返回值为新的 socket userdata，file_read 完成时为读取到的字符串数据，其他操作为 bytes_transferred
----@return fun(): integer, any, integer, integer|bee.socket.fd|string, integer # 迭代器，产生 (op, udata, status, bytes_transferred|accepted_socket|read_data, error_code)
+---@return fun(): integer, any, integer, integer|bee.socket.fd|string, integer, integer? # 迭代器，产生 (op, udata, status, bytes_transferred|accepted_socket|read_data, error_code, buffer_id)
 function asfd:poll()
 end
 
 ---等待已完成的I/O事件（阻塞）
 ---accept 操作完成时第四个返回值为新的 socket userdata，file_read 完成时为读取到的字符串数据，其他操作为 bytes_transferred
----@param timeout? integer 超时时间，单位为毫秒，-1表示无限等待
----@return fun(): integer, any, integer, integer|bee.socket.fd|string, integer # 迭代器，产生 (op, udata, status, bytes_transferred|accepted_socket|read_data, error_code)
+---@param timeout? number 超时时间，单位为毫秒，-1表示无限等待；可为小数（Linux 精确到纳秒，其他平台向上取整到毫秒）
+---@return fun(): integer, any, integer, integer|bee.socket.fd|string, integer, integer? # 迭代器，产生 (op, udata, status, bytes_transferred|accepted_socket|read_data, error_code, buffer_id)
 function asfd:wait(timeout)
 end
 
+---轮询已完成的I/O事件（非阻塞），结果写入调用方复用的表，避免逐个调用迭代器
+---每个 completion 依次占用 tbl 中连续 6 个槽位，顺序与 poll 的迭代器返回值相同：
+---op, udata, status, bytes_transferred|accepted_socket|read_data, error_code, buffer_id（无则为 nil）。
+---第 i 个 completion 从 tbl[(i-1)*6+1] 开始；超出返回数量的旧内容不会被清除。
+---@param tbl table 用于接收结果的表
+---@return integer # completion 数量
+function asfd:poll_into(tbl)
+end
+
+---等待已完成的I/O事件（阻塞），结果写入调用方复用的表，格式同 poll_into
+---@param tbl table 用于接收结果的表
+---@param timeout? number 超时时间，单位为毫秒，-1表示无限等待；可为小数（Linux 精确到纳秒，其他平台向上取整到毫秒）
+---@return integer # completion 数量
+function asfd:wait_into(tbl, timeout)
+end
+
+---以 name 打开本实例的 mailbox，供其他线程通过 async.mailbox(name) 投递（仅 Linux）
+---每个实例只能打开一个 mailbox；name 已被占用时抛出错误。实例 stop 或被回收时 mailbox 随之关闭。
+---@param name string mailbox 名称
+---@return boolean
+function asfd:mailbox(name)
+end
+
+---@class bee.async.opstats
+---@field submits integer 提交次数
+---@field completions integer 完成次数（multishot 每次完成都计入）
+---@field latency integer[] 提交到完成的耗时直方图：第 1 项为不足 1 微秒，第 i 项为 [2^(i-2), 2^(i-1)) 微秒，最后一个桶包含更慢的；末尾的空桶被省略
+
+---@class bee.async.stats
+---@field submit_failures integer 被拒绝的提交（io_uring 包括 SQ 已满）
+---@field inflight integer 已提交尚未完成的请求数
+---@field sync_completions integer 在提交调用内直接完成的请求数（epoll）
+---@field enter_calls integer io_uring_enter 调用次数（io_uring）
+---@field cq_overflows integer CQ 溢出后的冲刷次数（io_uring）
+---@field wait_calls integer epoll_wait 调用次数（epoll）
+---@field ctl_calls integer epoll_ctl 调用次数（epoll）
+---@field spin_ns integer 开启 busy_poll 时 wait 自旋的总时间（纳秒）
+---@field block_ns integer 开启 busy_poll 时 wait 自旋未果后阻塞的总时间（纳秒）
+---@field spin_hits integer 开启 busy_poll 时在自旋阶段就拿到结果的 wait 次数
+---@field ops table<integer, bee.async.opstats> 以 OP_* 为键的各操作统计，未使用过的操作不出现
+
+---获取后端统计（仅 Linux）
+---计数自创建起累计，stop 后清零；后端不支持的计数恒为 0。
+---multishot 操作从上一次完成开始计时；OP_POST 只计完成次数。
+---@return bee.async.stats
+function asfd:stats()
+end
+
 ---停止异步实例
 ---@return boolean
 function asfd:stop()
 end
 
+---查找名为 name 的 mailbox，可在任意线程调用（仅 Linux）
+---@param name string mailbox 名称
+---@return bee.async.mailbox?
+---@return string? errmsg
+function async.mailbox(name)
+end
+
+---跨线程投递入口（仅 Linux）
+---@class bee.async.mailbox
+local mailbox = {}
+
+---向 mailbox 所属实例投递一个值，线程安全
+---值经序列化后直接作为 completion 送达：op 为 OP_POST，udata 位置为该值，status 为 SUCCESS。
+---阻塞中的 wait 会被唤醒；同一线程的投递保持顺序。
+---io_uring 使用 IORING_OP_MSG_RING 写入目标 ring，epoll 使用 eventfd 加无锁队列。
+---mailbox 已关闭时返回 nil, err。
+---@param value any 投递的值（需可被序列化）
+---@return boolean?
+---@return string? errmsg
+function mailbox:post(value)
+end
+
 ---创建写缓冲区对象
 ---@param hwm? integer 高水位阈值（字节数），默认 65536
 ---@return bee.async.writebuf
@@ -184,11 +467,67 @@ end
 function readbuf:readline(sep)
 end
 
+---长度前缀帧格式
+---@class bee.async.framespec
+---@field header? 1|2|4|8|"varint" 长度前缀的字节数（无符号整数），或 LEB128 varint；默认为4。长度只计帧体
+---@field endian? "big"|"little" 定长前缀的字节序，默认为 "big"
+---@field max? integer 帧体的最大长度；超过缓冲区容量的帧同样视为过大
+
+---读取一个长度前缀帧，帧体只从 ring buffer 复制一次
+---@param spec? bee.async.framespec 帧格式
+---@return string? # 完整的帧体（不含前缀）；数据不足时返回 nil
+---@return string? # 帧过大（"frame too large"）或前缀非法（"bad frame header"）时的错误消息，此时数据保持不变
+function readbuf:read_frame(spec)
+end
+
+---读取当前已缓冲的全部完整帧
+---@param spec? bee.async.framespec 帧格式
+---@return string[] # 帧体列表，可能为空
+---@return string? # 遇到过大或非法的帧时的错误消息；之前的帧仍然返回
+function readbuf:read_frames(spec)
+end
+
+---submit_statx 的结果（时间为秒）
+---@class bee.async.statx
+---@field size integer 文件大小
+---@field mode integer st_mode（文件类型与权限位）
+---@field nlink integer 硬链接数
+---@field uid integer 所有者用户 id
+---@field gid integer 所有者组 id
+---@field ino integer inode 号
+---@field blocks integer 占用的 512 字节块数
+---@field blksize integer 推荐的 I/O 块大小
+---@field atime integer 最后访问时间
+---@field mtime integer 最后修改时间
+---@field ctime integer 最后状态改变时间
+
+---@class bee.async.options
+---@field max_completions? integer 最大完成事件数量，默认为64
+---@field entries? integer io_uring 提交队列大小，默认为256
+---@field cq_entries? integer io_uring 完成队列大小，默认为提交队列的两倍；超过内核上限时自动截断
+---@field sqpoll? boolean io_uring 启用内核 SQ 轮询线程，提交无需系统调用
+---@field sqpoll_idle? integer SQ 轮询线程空闲多少毫秒后休眠
+---@field coop_taskrun? boolean io_uring 启用 COOP_TASKRUN，不再用 IPI 打断本线程
+---@field defer_taskrun? boolean io_uring 启用 DEFER_TASKRUN，完成事件只在 poll/wait 中产生（隐含 single_issuer）
+---@field single_issuer? boolean io_uring 启用 SINGLE_ISSUER，只允许创建实例的线程提交
+---@field files? integer io_uring 固定文件表大小，默认为1024（不超过 RLIMIT_NOFILE）
+---@field zerocopy_threshold? integer io_uring 单次写入不少于该字节数时使用 SENDMSG_ZC 零拷贝发送，0 表示不启用（默认）。
+---写入的字符串在内核释放前一直被引用，Lua 仍只收到一次 completion；内核或 socket 不支持时自动退回普通发送。epoll 下始终为普通发送
+---@field file_threads? integer epoll 下执行文件 I/O 的工作线程数上限，默认为4
+---@field edge_triggered? boolean epoll 下每个 fd 只注册一次（EPOLLET）并缓存就绪状态，提交和完成不再调用 epoll_ctl。
+---此模式下关闭 fd 前应先调用 cancel(fd)（或 unregister_fd），否则复用同一 fd 号的新 socket 可能收不到事件；
+---fd 已就绪时 submit_poll 可能在其他地方读空 fd 后仍立即完成
+---@field busy_poll? integer wait 阻塞前先以非阻塞方式轮询至多该微秒数，0 表示不启用（默认）。
+---窗口按近期命中情况自适应：阻塞后很快等到结果时加倍，空闲时减半；耗时见 stats 的 spin_ns/block_ns
+
 ---创建异步I/O实例
----@param max_completions? integer 最大完成事件数量，默认为64
+---
+---传入 table 时可调整 io_uring/epoll 参数；其它后端忽略这些参数。
+---coop_taskrun/defer_taskrun/single_issuer 只是调度提示，内核不支持（或与 sqpoll 同时使用）时会被忽略。
+---@param options? integer|bee.async.options 最大完成事件数量（默认为64），或选项表
 ---@return bee.async.fd? # 异步I/O实例
 ---@return string? # 错误消息
-function async.create(max_completions)
+function async.create(options)
 end
 
 return async
@@ -22,7 +22,8 @@ local epoll = {}
 local epfd = {}
 
 ---等待事件
----@param timeout? integer 超时时间，单位为毫秒，-1表示无限等待
+---@param timeout? number 超时时间，单位为毫秒，可以是小数，负数表示无限等待
+---（Linux 5.11+ 与 kqueue 下精确到纳秒，其他情况向上取整到毫秒）
 ---@return fun(): any?, integer? iterator # 返回迭代器函数，迭代产生 (关联对象, 事件标志)
 function epfd:wait(timeout)
 end
@@ -59,10 +60,12 @@ function epfd:event_del(fd)
 end
 
 ---创建Epoll实例
+---busy_poll 大于0时，wait 阻塞前先以非阻塞方式轮询至多该微秒数，窗口按近期命中情况自适应（阻塞后很快等到事件时加倍，空闲时减半）
 ---@param max_events integer 最大事件数量（必须大于0）
+---@param busy_poll? integer 自旋窗口上限，单位为微秒，默认为0（不自旋）
 ---@return bee.epoll.fd? # Epoll实例对象
 ---@return string? # 错误消息
-function epoll.create(max_events)
+function epoll.create(max_events, busy_poll)
 end
 
 return epoll
@@ -74,6 +74,7 @@ end
 ---@param len? integer 最大接收长度，默认为缓冲区大小
 ---@return string|boolean|nil data # 成功返回数据，等待中返回false，失败返回nil
 ---@return bee.endpoint|string? endpoint_or_error # 成功返回发送方端点，失败返回错误消息
+---@return integer? segsize # 开启 udp_gro 且数据被合并时返回分段大小，data 按该大小切分（最后一段可能更短）
 function fd:recvfrom(len)
 end
 
@@ -86,6 +87,29 @@ end
 function fd:sendto(data, address, port)
 end
 
+---批量接收UDP数据报（Linux 下为一次 recvmmsg 系统调用）
+---最多接收 #eps 个数据报，第 i 个数据报的内容写入 msgs[i]，
+---发送方地址直接写入预先分配的端点 eps[i]（不创建新的端点对象）。
+---传入 segs 时 segs[i] 为 GRO 分段大小（未合并为 0）。
+---@param msgs string[] 接收数据的数组
+---@param eps bee.endpoint[] 预先分配的端点数组，决定最多接收的个数
+---@param size? integer 每个数据报的最大长度，默认为缓冲区大小
+---@param segs? integer[] 接收分段大小的数组
+---@return integer|boolean|nil # 成功返回接收的数据报个数，等待中返回false，失败返回nil
+---@return string? # 错误消息
+function fd:recvmmsg(msgs, eps, size, segs)
+end
+
+---批量发送UDP数据报（Linux 下为一次 sendmmsg 系统调用）
+---msgs[i] 发送到 eps[i]；已 connect 的套接字可以传 nil 作为 eps。
+---@param msgs string[] 要发送的数据报
+---@param eps? bee.endpoint[] 目标端点数组
+---@param n? integer 发送前 n 个，默认为 #msgs
+---@return integer|boolean|nil # 成功返回已发送的数据报个数，等待中返回false，失败返回nil
+---@return string? # 错误消息
+function fd:sendmmsg(msgs, eps, n)
+end
+
 ---关闭套接字的读/写方向
 ---@param how? "r"|"w" 关闭方向：r=读，w=写，默认关闭双向
 ---@return boolean? # 成功返回true，失败返回nil
@@ -108,7 +132,11 @@ function fd:info(which)
 end
 
 ---设置套接字选项
----@param opt "reuseaddr"|"sndbuf"|"rcvbuf" 选项名称
+---udp_segment（仅 Linux）：UDP GSO，之后每次发送的数据按 value 字节切分为多个数据报，0 为关闭。
+---udp_gro（仅 Linux）：UDP GRO，接收时内核可以把多个数据报合并成一次返回，
+---此时 recvfrom/recvmmsg 会报告分段大小，缓冲区应足够大（如 65535）。
+---busy_poll（仅 Linux）：SO_BUSY_POLL，接收无数据时在网卡队列上忙轮询 value 微秒；调高到超过系统默认值需要 CAP_NET_ADMIN。
+---@param opt "reuseaddr"|"sndbuf"|"rcvbuf"|"nodelay"|"udp_segment"|"udp_gro"|"busy_poll" 选项名称
 ---@param value integer 选项值
 ---@return boolean? # 成功返回true，失败返回nil
 ---@return string? # 错误消息
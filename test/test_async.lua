@@ -11,6 +11,7 @@ local SUCCESS <const> = async.SUCCESS
 local CLOSE <const> = async.CLOSE
 local ERROR <const> = async.ERROR
 local CANCEL <const> = async.CANCEL
+local TIMEOUT <const> = async.TIMEOUT
 
 local function SimpleServer(as, protocol, ...)
     local fd = assert(socket.create(protocol))
@@ -41,8 +42,8 @@ local function wait_completion(as, timeout)
     timeout = timeout or 1000
     local start = time.monotonic()
     while time.monotonic() - start < timeout do
-        for op, token, st, data, errcode in as:wait(100) do
-            return op, token, st, data, errcode
+        for op, token, st, data, errcode, bid in as:wait(100) do
+            return op, token, st, data, errcode, bid
         end
     end
     lt.failure("wait_completion timeout")
@@ -56,6 +57,76 @@ function m.test_create()
     lt.assertIsUserdata(as)
 end
 
+local function roundtrip(as)
+    local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+    local cfd <close> = SimpleClient(as, "tcp", sfd:info "socket")
+    local newfd <close> = wait_accept(as, sfd)
+    local wb = assert(async.writebuf(1024))
+    wb:write("hello")
+    lt.assertEquals(as:submit_write(wb, cfd, "write"), true)
+    local op, token, status = wait_completion(as)
+    lt.assertEquals(op, async.OP_WRITE)
+    lt.assertEquals(token, "write")
+    lt.assertEquals(status, SUCCESS)
+    local rb = assert(async.readbuf(64))
+    lt.assertEquals(as:submit_read(rb, newfd, "read"), true)
+    op, token, status = wait_completion(as)
+    lt.assertEquals(op, async.OP_READ)
+    lt.assertEquals(token, "read")
+    lt.assertEquals(status, SUCCESS)
+    lt.assertEquals(rb:read(5), "hello")
+end
+
+--- 测试选项表创建
+function m.test_create_options()
+    lt.assertFailed("max_completions is less than or equal to zero.", async.create { max_completions = 0 })
+    lt.assertError(async.create, { entries = -1 })
+    for _, options in ipairs {
+        {},
+        { max_completions = 8, entries = 8, cq_entries = 64 },
+        { sqpoll = true, sqpoll_idle = 10 },
+        { coop_taskrun = true },
+        { single_issuer = true },
+        { defer_taskrun = true },
+    } do
+        local as <close> = assert(async.create(options))
+        roundtrip(as)
+    end
+end
+
+--- 测试提交队列满时自动提交给内核而不是失败
+function m.test_submit_queue_full()
+    local as <close> = assert(async.create { entries = 2 })
+    local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+    local _, port = sfd:info "socket":value()
+    local N <const> = 8
+    local clients = {}
+    local servers = {}
+    local wbs = {}
+    for i = 1, N do
+        clients[i] = SimpleClient(as, "tcp", "127.0.0.1", port)
+        servers[i] = wait_accept(as, sfd)
+    end
+    for i = 1, N do
+        wbs[i] = assert(async.writebuf(1024))
+        wbs[i]:write("msg"..i)
+        lt.assertEquals(as:submit_write(wbs[i], clients[i], i), true)
+    end
+    local done = 0
+    local deadline = time.monotonic() + 1000
+    while done < N and time.monotonic() < deadline do
+        for _, _, status in as:wait(100) do
+            lt.assertEquals(status, SUCCESS)
+            done = done + 1
+        end
+    end
+    lt.assertEquals(done, N)
+    for i = 1, N do
+        clients[i]:close()
+        servers[i]:close()
+    end
+end
+
 --- 测试枚举值
 function m.test_enum()
     lt.assertIsNumber(SUCCESS)
@@ -236,6 +307,45 @@ function m.test_file_read_write_offset()
     fs.remove(filepath)
 end
 
+--- 测试同时提交多个文件读操作（epoll 下由工作线程并发执行）
+function m.test_file_read_many()
+    local as <close> = assert(async.create { file_threads = 2 })
+    local fs = require "bee.filesystem"
+    local filepath = fs.current_path() / "test_async_many.txt"
+    local N <const> = 16
+    do
+        local f = assert(io.open(filepath:string(), "wb"))
+        for i = 1, N do
+            f:write(("%04d"):format(i))
+        end
+        f:close()
+    end
+
+    local rf = assert(io.open(filepath:string(), "rb"))
+    assert(as:associate_file(rf))
+    for i = 1, N do
+        lt.assertEquals(as:submit_file_read(rf, 4, (i - 1) * 4, i), true)
+    end
+    local seen = {}
+    local n = 0
+    local start = time.monotonic()
+    while n < N and time.monotonic() - start < 1000 do
+        for op, token, status, bytes in as:wait(100) do
+            lt.assertEquals(op, async.OP_FILE_READ)
+            lt.assertEquals(status, SUCCESS)
+            lt.assertEquals(bytes, ("%04d"):format(token))
+            seen[token] = true
+            n = n + 1
+        end
+    end
+    for i = 1, N do
+        lt.assertEquals(seen[i], true)
+    end
+
+    rf:close()
+    fs.remove(filepath)
+end
+
 --- 测试读取已关闭的连接
 function m.test_read_closed()
     local as <close> = assert(async.create(64))
@@ -301,6 +411,40 @@ function m.test_multiple_requests()
     end
 end
 
+--- 测试 wait_into/poll_into：completion 批量写入复用的表
+function m.test_wait_into()
+    local as <close> = assert(async.create(64))
+    local t = {}
+    lt.assertEquals(as:poll_into(t), 0)
+    lt.assertEquals(as:wait_into(t, 10), 0)
+    lt.assertError(as.wait_into, as, nil, 10)
+
+    local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+    local cfd <close> = SimpleClient(as, "tcp", sfd:info "socket")
+    local newfd <close> = wait_accept(as, sfd)
+    local rb = assert(async.readbuf(64))
+    local wb = assert(async.writebuf(1024))
+    wb:write("hello")
+    lt.assertEquals(as:submit_read(rb, newfd, "read"), true)
+    lt.assertEquals(as:submit_write(wb, cfd, "write"), true)
+
+    local got = {}
+    local deadline = time.monotonic() + 1000
+    while (not got.read or not got.write) and time.monotonic() < deadline do
+        local n = as:wait_into(t, 100)
+        for i = 0, n - 1 do
+            local op, token, status, bytes, errcode, bid = table.unpack(t, i * 6 + 1, i * 6 + 6)
+            lt.assertEquals(status, SUCCESS)
+            lt.assertEquals(errcode, 0)
+            lt.assertEquals(bid, nil)
+            got[token] = { op, bytes }
+        end
+    end
+    lt.assertEquals(got.write, { async.OP_WRITE, 0 })
+    lt.assertEquals(got.read, { async.OP_READ, 5 })
+    lt.assertEquals(rb:read(5), "hello")
+end
+
 --- 测试 readbuf 创建和 ring buffer 基本操作
 function m.test_readbuf()
     -- 无效参数
@@ -395,9 +539,95 @@ function m.test_readline()
     lt.assertEquals(rb:readline(), nil)
     lt.assertEquals(rb:read(), "no-sep")
 
+    -- 行分段到达并跨越环形缓冲区边界，分隔符也被拆开；中途换分隔符查找不影响结果
+    local line = string.rep("ab\r", 30) .. "\r\n"
+    for i = 1, 6 do
+        send(line:sub(1, 40), "p1")
+        recv()
+        lt.assertEquals(rb:readline(), nil)
+        send(line:sub(41, #line - 1), "p2")
+        recv()
+        lt.assertEquals(rb:readline(), nil)
+        lt.assertEquals(rb:readline("\n"), nil)
+        send(line:sub(#line), "p3")
+        recv()
+        if i % 2 == 0 then
+            lt.assertEquals(rb:readline("\n"), line)
+        else
+            lt.assertEquals(rb:readline(), line)
+        end
+        lt.assertEquals(rb:readline(), nil)
+    end
+
     newfd:close()
 end
 
+--- 测试 rb:read_frame / rb:read_frames
+function m.test_read_frame()
+    local as <close> = assert(async.create(64))
+    local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+    local cfd <close> = SimpleClient(as, "tcp", sfd:info "socket")
+    local newfd <close> = wait_accept(as, sfd)
+    local rb = assert(async.readbuf(256))
+
+    local function feed(data)
+        local w = assert(async.writebuf(64 * 1024))
+        w:write(data)
+        lt.assertEquals(as:submit_write(w, cfd, "send"), true)
+        wait_completion(as)
+        local got = 0
+        while got < #data do
+            lt.assertEquals(as:submit_read(rb, newfd, "recv"), true)
+            local _, _, status, n = wait_completion(as)
+            lt.assertEquals(status, SUCCESS)
+            got = got + n
+        end
+    end
+
+    -- 默认 4 字节大端前缀；不完整的帧留在缓冲区
+    local frames = string.pack(">s4>s4>s4", "hello", "", "world")
+    feed(frames .. string.pack(">s4", "tail"):sub(1, 6))
+    lt.assertEquals(rb:read_frame { header = 4, endian = "big" }, "hello")
+    lt.assertEquals(rb:read_frames(), { "", "world" })
+    lt.assertEquals(rb:read_frame(), nil)
+    feed("il")
+    lt.assertEquals(rb:read_frame(), "tail")
+    lt.assertEquals(rb:read(), nil)
+
+    -- 小端与 varint 前缀
+    feed(string.pack("<s2<s8", "ab", "cd"))
+    lt.assertEquals(rb:read_frame { header = 2, endian = "little" }, "ab")
+    lt.assertEquals(rb:read_frame { header = 8, endian = "little" }, "cd")
+    local long = string.rep("v", 200)
+    feed("\x03abc\xc8\x01" .. long)
+    lt.assertEquals(rb:read_frames { header = "varint" }, { "abc", long })
+
+    -- 帧跨越 ring buffer 边界
+    for i = 1, 8 do
+        local body = string.rep(string.char(64 + i), 60 + i)
+        feed(string.pack(">s2", body) .. string.pack(">s2", body):sub(1, 1))
+        lt.assertEquals(rb:read_frames { header = 2 }, { body })
+        feed(string.pack(">s2", body):sub(2))
+        lt.assertEquals(rb:read_frame { header = 2 }, body)
+    end
+
+    -- 过大或非法的帧：返回错误且不消耗数据
+    feed(string.pack(">s1>s1", "ok", "toolong"))
+    lt.assertEquals({ rb:read_frames { header = 1, max = 4 } }, { { "ok" }, "frame too large" })
+    lt.assertFailed("frame too large", rb:read_frame { header = 1, max = 4 })
+    lt.assertEquals(rb:read_frame { header = 1 }, "toolong")
+    feed(string.pack(">I4", 1000))
+    lt.assertFailed("frame too large", rb:read_frame())
+    rb:read()
+    feed(string.rep("\xff", 10))
+    lt.assertFailed("bad frame header", rb:read_frame { header = "varint" })
+    rb:read()
+
+    lt.assertError(rb.read_frame, rb, { header = 3 })
+    lt.assertError(rb.read_frame, rb, { header = "fixed" })
+    lt.assertError(rb.read_frame, rb, { endian = "middle" })
+end
+
 if platform.os == "windows" then
     --- 测试 associate 和 cancel（仅 Windows）
     function m.test_associate_cancel()
@@ -667,3 +897,1030 @@ function m.test_write_batch()
 
     newfd:close()
 end
+
+--- 测试提交时数据已就绪：读立即得到已缓冲的数据，写满发送缓冲区后仍能完成
+function m.test_submit_ready()
+    local as <close> = assert(async.create(64))
+    local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+    local cfd <close> = SimpleClient(as, "tcp", sfd:info "socket")
+    local newfd <close> = wait_accept(as, sfd)
+
+    -- 数据在 submit_read 之前已到达
+    lt.assertEquals(cfd:send "ready", 5)
+    local s <close> = select.create()
+    s:event_add(newfd, select.SELECT_READ)
+    s:wait()
+    local rb = assert(async.readbuf(64))
+    lt.assertEquals(as:submit_read(rb, newfd, "r"), true)
+    local op, token, status, n = wait_completion(as)
+    lt.assertEquals(op, async.OP_READ)
+    lt.assertEquals(token, "r")
+    lt.assertEquals(status, SUCCESS)
+    lt.assertEquals(n, 5)
+    lt.assertEquals(rb:read(5), "ready")
+
+    -- 超过发送缓冲区的写入：部分写出后等待可写再继续
+    local payload = string.rep("x", 8 * 1024 * 1024)
+    local wb = assert(async.writebuf(64 * 1024))
+    wb:write(payload)
+    lt.assertEquals(as:submit_write(wb, cfd, "w"), true)
+    local big = assert(async.readbuf(64 * 1024))
+    -- 一次 wait 可能同时返回读和写的 completion，需逐个处理
+    local received = 0
+    local written = false
+    local reading = false
+    local start = time.monotonic()
+    while not written or received < #payload do
+        lt.assertEquals(time.monotonic() - start < 5000, true)
+        if not reading and received < #payload then
+            lt.assertEquals(as:submit_read(big, newfd, "r"), true)
+            reading = true
+        end
+        for wop, wtoken, wstatus, wn in as:wait(100) do
+            lt.assertEquals(wstatus, SUCCESS)
+            if wtoken == "w" then
+                lt.assertEquals(wop, async.OP_WRITE)
+                written = true
+            else
+                lt.assertEquals(wop, async.OP_READ)
+                received = received + wn
+                big:read(wn)
+                reading = false
+            end
+        end
+    end
+    lt.assertEquals(received, #payload)
+end
+
+--- 测试零拷贝发送：大块写入仍只产生一次 OP_WRITE completion，数据完整
+function m.test_write_zerocopy()
+    local as <close> = assert(async.create { zerocopy_threshold = 64 * 1024 })
+    local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+    local cfd <close> = SimpleClient(as, "tcp", sfd:info "socket")
+    local newfd <close> = wait_accept(as, sfd)
+
+    local parts = {}
+    for i = 1, 4 do
+        parts[i] = string.rep(string.char(0x40 + i), 1024 * 1024)
+    end
+    local expected = table.concat(parts)
+    local wb = assert(async.writebuf(64 * 1024))
+    for _, s in ipairs(parts) do wb:write(s) end
+    lt.assertEquals(as:submit_write(wb, cfd, "zc_write"), true)
+
+    local rb = assert(async.readbuf(256 * 1024))
+    local received = {}
+    local nreceived = 0
+    local writes = 0
+    local reading = false
+    local deadline = time.monotonic() + 5000
+    while (writes == 0 or nreceived < #expected) and time.monotonic() < deadline do
+        if not reading and nreceived < #expected then
+            lt.assertEquals(as:submit_read(rb, newfd, "r"), true)
+            reading = true
+        end
+        for op, token, status, bytes in as:wait(100) do
+            lt.assertEquals(status, SUCCESS)
+            if op == async.OP_WRITE then
+                lt.assertEquals(token, "zc_write")
+                writes = writes + 1
+            else
+                lt.assertEquals(op, async.OP_READ)
+                received[#received+1] = rb:read(bytes)
+                nreceived = nreceived + bytes
+                reading = false
+            end
+        end
+    end
+    lt.assertEquals(writes, 1)
+    lt.assertEquals(wb:buffered(), 0)
+    lt.assertEquals(nreceived, #expected)
+    lt.assertEquals(table.concat(received) == expected, true)
+end
+
+if platform.os == "linux" then
+    --- 测试 buffer-select 接收：数据到达时才从共享缓冲池中挑选缓冲区
+    function m.test_bufpool_recv()
+        local as <close> = assert(async.create(64))
+        local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+        local cfd <close> = SimpleClient(as, "tcp", sfd:info "socket")
+        local newfd = wait_accept(as, sfd)
+
+        lt.assertErrorMsgEquals("bufsize must be positive", as.bufpool, as, 0, 1)
+        lt.assertErrorMsgEquals("count must be in [1, 32768]", as.bufpool, as, 16, 0)
+        local nopool, err = as:bufpool(math.maxinteger, 32768)
+        lt.assertEquals(nopool, nil)
+        lt.assertIsString(err)
+        nopool, err = as:bufpool(1 << 31, 4)
+        lt.assertEquals(nopool, nil)
+        lt.assertIsString(err)
+        local pool = assert(as:bufpool(16, 1))
+
+        lt.assertEquals(as:submit_recv(pool, newfd, "recv1"), true)
+        cfd:send "hello"
+        local op, token, status, bytes, errcode, bid = wait_completion(as)
+        lt.assertEquals(op, async.OP_RECV)
+        lt.assertEquals(token, "recv1")
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(bytes, 5)
+        lt.assertEquals(errcode, 0)
+        lt.assertIsNumber(bid)
+        lt.assertEquals(as:bufpool_read(pool, bid, bytes), "hello")
+
+        -- 唯一的缓冲区尚未归还：下一次接收以 ENOBUFS 失败
+        cfd:send "world"
+        lt.assertEquals(as:submit_recv(pool, newfd, "recv2"), true)
+        op, token, status, bytes, errcode, bid = wait_completion(as)
+        lt.assertEquals(token, "recv2")
+        lt.assertEquals(status, ERROR)
+        lt.assertEquals(bid, nil)
+
+        -- 归还后可以继续接收
+        as:bufpool_recycle(pool, 0)
+        lt.assertEquals(as:submit_recv(pool, newfd, "recv3"), true)
+        op, token, status, bytes, errcode, bid = wait_completion(as)
+        lt.assertEquals(token, "recv3")
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(as:bufpool_read(pool, bid, bytes), "world")
+        as:bufpool_recycle(pool, bid)
+
+        -- 重复归还被拒绝：池中不会出现同一缓冲区的两份，第二次接收仍以 ENOBUFS 失败
+        lt.assertErrorMsgEquals("buffer is not in use", as.bufpool_recycle, as, pool, bid)
+        cfd:send "again"
+        lt.assertEquals(as:submit_recv(pool, newfd, "recv5"), true)
+        op, token, status, bytes, errcode, bid = wait_completion(as)
+        lt.assertEquals(token, "recv5")
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(as:bufpool_read(pool, bid, bytes), "again")
+        cfd:send "more"
+        lt.assertEquals(as:submit_recv(pool, newfd, "recv6"), true)
+        local _, token6, status6 = wait_completion(as)
+        lt.assertEquals(token6, "recv6")
+        lt.assertEquals(status6, ERROR)
+        as:bufpool_recycle(pool, bid)
+        lt.assertEquals(as:submit_recv(pool, newfd, "recv7"), true)
+        op, token, status, bytes, errcode, bid = wait_completion(as)
+        lt.assertEquals(token, "recv7")
+        lt.assertEquals(as:bufpool_read(pool, bid, bytes), "more")
+        as:bufpool_recycle(pool, bid)
+
+        -- 对端关闭：CLOSE 且不返回缓冲区
+        cfd:close()
+        lt.assertEquals(as:submit_recv(pool, newfd, "recv4"), true)
+        op, token, status, bytes, errcode, bid = wait_completion(as)
+        lt.assertEquals(token, "recv4")
+        lt.assertEquals(status, CLOSE)
+        lt.assertEquals(bid, nil)
+
+        newfd:close()
+    end
+
+    --- 测试 multishot recv：一次提交，持续接收直到对端关闭
+    function m.test_recv_multishot()
+        local as <close> = assert(async.create(64))
+        local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+        local cfd <close> = SimpleClient(as, "tcp", sfd:info "socket")
+        local newfd = wait_accept(as, sfd)
+
+        local pool = assert(as:bufpool(64, 4))
+        local recv_token = { op = "recv_multishot" }
+        lt.assertEquals(as:submit_recv_multishot(pool, newfd, recv_token), true)
+
+        local received = {}
+        local function recv_all(n)
+            local got = 0
+            while got < n do
+                local op, token, status, bytes, _, bid = wait_completion(as)
+                lt.assertEquals(op, async.OP_RECV)
+                lt.assertEquals(token, recv_token)
+                lt.assertEquals(status, SUCCESS)
+                received[#received+1] = as:bufpool_read(pool, bid, bytes)
+                as:bufpool_recycle(pool, bid)
+                got = got + bytes
+            end
+        end
+        for i = 1, 3 do
+            cfd:send("msg"..i)
+            recv_all(4)
+        end
+        lt.assertEquals(table.concat(received), "msg1msg2msg3")
+
+        -- 对端关闭后产生最后一次 completion
+        cfd:close()
+        local op, token, status, _, _, bid = wait_completion(as)
+        lt.assertEquals(op, async.OP_RECV)
+        lt.assertEquals(token, recv_token)
+        lt.assertEquals(status, CLOSE)
+        lt.assertEquals(bid, nil)
+
+        newfd:close()
+    end
+
+    --- 测试 cancel：挂起的操作以 CANCEL 完成，连接可以继续使用
+    function m.test_cancel()
+        local as <close> = assert(async.create(64))
+        local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+        local cfd <close> = SimpleClient(as, "tcp", sfd:info "socket")
+        local newfd = wait_accept(as, sfd)
+
+        local rb = assert(async.readbuf(64))
+        lt.assertEquals(as:submit_read(rb, newfd, "read1"), true)
+        as:cancel(newfd)
+        local op, token, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_READ)
+        lt.assertEquals(token, "read1")
+        lt.assertEquals(status, CANCEL)
+
+        -- 取消后不关闭连接，仍可继续读取
+        lt.assertEquals(as:submit_read(rb, newfd, "read2"), true)
+        cfd:send "hello"
+        op, token, status = wait_completion(as)
+        lt.assertEquals(token, "read2")
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(rb:read(5), "hello")
+
+        newfd:close()
+    end
+
+    --- 测试按操作类型取消：只取消匹配的操作
+    function m.test_cancel_op()
+        local as <close> = assert(async.create(64))
+        local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+        local cfd <close> = SimpleClient(as, "tcp", sfd:info "socket")
+        local newfd = wait_accept(as, sfd)
+
+        local rb = assert(async.readbuf(64))
+        lt.assertEquals(as:submit_read(rb, newfd, "read"), true)
+        lt.assertEquals(as:submit_accept_multishot(sfd, "accept"), true)
+
+        -- 不匹配的操作类型不产生 completion
+        as:cancel(newfd, async.OP_WRITE)
+        for _ in as:wait(50) do
+            lt.failure "unexpected completion"
+        end
+
+        as:cancel(sfd, async.OP_ACCEPT)
+        local op, token, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_ACCEPT)
+        lt.assertEquals(token, "accept")
+        lt.assertEquals(status, CANCEL)
+
+        as:cancel(newfd, async.OP_READ)
+        op, token, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_READ)
+        lt.assertEquals(token, "read")
+        lt.assertEquals(status, CANCEL)
+
+        newfd:close()
+    end
+
+    --- 测试 multishot accept：一次提交，每个连接产生一次 completion
+    function m.test_tcp_accept_multishot()
+        local as <close> = assert(async.create(64))
+        local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+        local _, port = sfd:info "socket":value()
+
+        local accept_token = { op = "accept_multishot" }
+        lt.assertEquals(as:submit_accept_multishot(sfd, accept_token), true)
+
+        local clients = {}
+        for i = 1, 3 do
+            clients[i] = SimpleClient(as, "tcp", "127.0.0.1", port)
+        end
+        local accepted = {}
+        local deadline = time.monotonic() + 1000
+        while #accepted < 3 and time.monotonic() < deadline do
+            for op, token, status, newfd in as:wait(100) do
+                lt.assertEquals(op, async.OP_ACCEPT)
+                lt.assertEquals(token, accept_token)
+                lt.assertEquals(status, SUCCESS)
+                lt.assertIsUserdata(newfd)
+                accepted[#accepted+1] = newfd
+            end
+        end
+        lt.assertEquals(#accepted, 3)
+        for i = 1, 3 do
+            accepted[i]:close()
+            clients[i]:close()
+        end
+    end
+
+    --- 测试固定文件表：注册后读写正常，注销后关闭能让对端读到 CLOSE
+    function m.test_register_fd()
+        local as <close> = assert(async.create { files = 16 })
+        local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+        local cfd = SimpleClient(as, "tcp", sfd:info "socket")
+        local newfd <close> = wait_accept(as, sfd)
+        lt.assertEquals(as:register_fd(cfd), true)
+        lt.assertEquals(as:register_fd(cfd), true)
+        lt.assertEquals(as:register_fd(newfd), true)
+
+        local wb = assert(async.writebuf(1024))
+        wb:write("fixed")
+        lt.assertEquals(as:submit_write(wb, cfd, "write"), true)
+        local op, _, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_WRITE)
+        lt.assertEquals(status, SUCCESS)
+        local rb = assert(async.readbuf(64))
+        lt.assertEquals(as:submit_read(rb, newfd, "read"), true)
+        op, _, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_READ)
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(rb:read(5), "fixed")
+
+        as:unregister_fd(cfd)
+        cfd:close()
+        lt.assertEquals(as:submit_read(rb, newfd, "eof"), true)
+        op, _, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_READ)
+        lt.assertEquals(status, CLOSE)
+        as:unregister_fd(newfd)
+    end
+
+    --- 测试 deadline：超时的操作以 TIMEOUT 完成，按时完成的操作不受影响
+    function m.test_deadline_read()
+        local as <close> = assert(async.create(64))
+        local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+        local cfd <close> = SimpleClient(as, "tcp", sfd:info "socket")
+        local newfd = wait_accept(as, sfd)
+
+        local rb = assert(async.readbuf(64))
+        local start = time.monotonic()
+        lt.assertEquals(as:submit_read(rb, newfd, "read1", 20), true)
+        local op, token, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_READ)
+        lt.assertEquals(token, "read1")
+        lt.assertEquals(status, TIMEOUT)
+        lt.assertEquals(time.monotonic() - start >= 15, true)
+
+        -- 超时后连接仍可继续使用
+        lt.assertEquals(as:submit_read(rb, newfd, "read2", 1000), true)
+        cfd:send "hello"
+        op, token, status = wait_completion(as)
+        lt.assertEquals(token, "read2")
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(rb:read(5), "hello")
+
+        lt.assertError(as.submit_read, as, rb, newfd, "read3", -1)
+        newfd:close()
+    end
+
+    --- 测试 accept 的 deadline
+    function m.test_deadline_accept()
+        local as <close> = assert(async.create(64))
+        local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+        lt.assertEquals(as:submit_accept(sfd, "accept1", 20), true)
+        local op, token, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_ACCEPT)
+        lt.assertEquals(token, "accept1")
+        lt.assertEquals(status, TIMEOUT)
+
+        lt.assertEquals(as:submit_accept(sfd, "accept2", 1000), true)
+        local cfd <close> = SimpleClient(as, "tcp", sfd:info "socket")
+        local newfd
+        op, token, status, newfd = wait_completion(as)
+        lt.assertEquals(token, "accept2")
+        lt.assertEquals(status, SUCCESS)
+        newfd:close()
+    end
+
+    --- 测试 submit_timer：定时器按时从 completion 迭代器返回
+    function m.test_timer()
+        local as <close> = assert(async.create(64))
+        local start = time.monotonic()
+        local t1 = as:submit_timer(30, "t1")
+        local t2 = as:submit_timer(10, "t2")
+        lt.assertIsNumber(t1)
+        lt.assertIsNumber(t2)
+        local op, token, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_TIMER)
+        lt.assertEquals(token, "t2")
+        lt.assertEquals(status, SUCCESS)
+        op, token, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_TIMER)
+        lt.assertEquals(token, "t1")
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(time.monotonic() - start >= 25, true)
+
+        as:submit_timer(0, "t0")
+        op, token, status = wait_completion(as)
+        lt.assertEquals(token, "t0")
+        lt.assertEquals(status, SUCCESS)
+
+        lt.assertError(as.submit_timer, as, -1, "bad")
+    end
+
+    --- 测试 cancel_timer：被取消的定时器以 CANCEL 完成，其余不受影响
+    function m.test_timer_cancel()
+        local as <close> = assert(async.create(64))
+        local t1 = as:submit_timer(10000, "t1")
+        as:submit_timer(20, "t2")
+        as:cancel_timer(t1)
+        as:cancel_timer(t1)
+        local op, token, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_TIMER)
+        lt.assertEquals(token, "t1")
+        lt.assertEquals(status, CANCEL)
+        op, token, status = wait_completion(as)
+        lt.assertEquals(token, "t2")
+        lt.assertEquals(status, SUCCESS)
+        for _ in as:wait(30) do
+            lt.failure "unexpected completion"
+        end
+
+        -- 已触发定时器的 id 不会被新定时器复用，取消它不影响新定时器
+        local t3 = as:submit_timer(0, "t3")
+        op, token, status = wait_completion(as)
+        lt.assertEquals(token, "t3")
+        local t4 = as:submit_timer(20, "t4")
+        lt.assertNotEquals(t4, t3)
+        as:cancel_timer(t3)
+        op, token, status = wait_completion(as)
+        lt.assertEquals(token, "t4")
+        lt.assertEquals(status, SUCCESS)
+    end
+
+    --- 测试文件 open/write/fsync/statx/close 全部走异步操作
+    function m.test_file_open_close()
+        local as <close> = assert(async.create(64))
+        local fs = require "bee.filesystem"
+        local filepath = (fs.current_path() / "test_async_open.txt"):string()
+
+        lt.assertEquals(as:submit_file_open(filepath, "w+", "open"), true)
+        local op, token, status, f = wait_completion(as)
+        lt.assertEquals(op, async.OP_FILE_OPEN)
+        lt.assertEquals(token, "open")
+        lt.assertEquals(status, SUCCESS)
+        lt.assertIsUserdata(f)
+
+        lt.assertEquals(as:submit_file_write(f, "hello statx", 0, "write"), true)
+        op, _, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_FILE_WRITE)
+        lt.assertEquals(status, SUCCESS)
+
+        lt.assertEquals(as:submit_fsync(f, "fsync"), true)
+        op, token, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_FSYNC)
+        lt.assertEquals(token, "fsync")
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(as:submit_fdatasync(f, "fdatasync"), true)
+        op, token, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_FSYNC)
+        lt.assertEquals(token, "fdatasync")
+        lt.assertEquals(status, SUCCESS)
+
+        lt.assertEquals(as:submit_statx(f, "fstat"), true)
+        local st
+        op, token, status, st = wait_completion(as)
+        lt.assertEquals(op, async.OP_STATX)
+        lt.assertEquals(token, "fstat")
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(st.size, 11)
+
+        lt.assertEquals(as:submit_statx(filepath, "stat"), true)
+        op, token, status, st = wait_completion(as)
+        lt.assertEquals(token, "stat")
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(st.size, 11)
+        lt.assertEquals(math.abs(st.mtime - os.time()) < 60, true)
+
+        lt.assertEquals(as:submit_file_close(f, "close"), true)
+        lt.assertError(f.read, f)
+        op, token, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_FILE_CLOSE)
+        lt.assertEquals(token, "close")
+        lt.assertEquals(status, SUCCESS)
+
+        lt.assertEquals(as:submit_file_open(filepath, "r", "reopen"), true)
+        op, _, status, f = wait_completion(as)
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(f:read "a", "hello statx")
+        f:close()
+
+        fs.remove(filepath)
+        lt.assertEquals(as:submit_file_open(filepath, "r", "missing"), true)
+        local errcode
+        op, _, status, _, errcode = wait_completion(as)
+        lt.assertEquals(op, async.OP_FILE_OPEN)
+        lt.assertEquals(status, ERROR)
+        lt.assertEquals(errcode ~= 0, true)
+        lt.assertEquals(as:submit_statx(filepath, "missing"), true)
+        op, _, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_STATX)
+        lt.assertEquals(status, ERROR)
+
+        lt.assertError(as.submit_file_open, as, filepath, "x", "bad")
+    end
+
+    --- 测试 stop：尚未执行的 file_close 仍会关闭文件，fd 不泄漏
+    function m.test_file_close_stop()
+        local fs = require "bee.filesystem"
+        local thread = require "bee.thread"
+        local filepath = (fs.current_path() / "test_async_close_stop.txt"):string()
+        local fifopath = (fs.current_path() / "test_async_close_stop.fifo"):string()
+        fs.remove(fifopath)
+        assert(os.execute(("mkfifo %q"):format(fifopath)))
+        local function count_fds()
+            local n = 0
+            for _ in fs.pairs "/proc/self/fd" do
+                n = n + 1
+            end
+            return n
+        end
+        local before = count_fds()
+        local as = assert(async.create(64, { file_threads = 1 }))
+        -- epoll 下唯一的工作线程阻塞在 FIFO 的 open 上，之后的 close 留在队列中
+        lt.assertEquals(as:submit_file_open(fifopath, "r", "fifo"), true)
+        for i = 1, 16 do
+            local f = assert(io.open(filepath, "w"))
+            lt.assertEquals(as:submit_file_close(f, i), true)
+        end
+        local thd = thread.create([[
+            local thread = require "bee.thread"
+            thread.sleep(50)
+            assert(io.open(..., "r+")):close()
+        ]], fifopath)
+        as:stop()
+        thread.wait(thd)
+        lt.assertEquals(thread.errlog(), nil)
+        lt.assertEquals(count_fds(), before)
+        fs.remove(filepath)
+        fs.remove(fifopath)
+    end
+
+    --- 测试 sendfile：文件内容直接发送到 socket，只产生一个 completion
+    function m.test_sendfile()
+        local as <close> = assert(async.create(64))
+        local fs = require "bee.filesystem"
+        local filepath = (fs.current_path() / "test_async_sendfile.bin"):string()
+        local chunk = {}
+        for i = 0, 255 do
+            chunk[#chunk + 1] = string.char(i)
+        end
+        local content = string.rep(table.concat(chunk), 3 * 4096 + 7)
+        local f <close> = assert(io.open(filepath, "w+b"))
+        f:write(content)
+
+        local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+        local cfd <close> = SimpleClient(as, "tcp", sfd:info "socket")
+        local newfd <close> = wait_accept(as, sfd)
+
+        local function transfer(offset, len, expected)
+            lt.assertEquals(as:submit_sendfile(newfd, f, offset, len, "sendfile"), true)
+            local got = {}
+            local n = 0
+            local sent
+            local start = time.monotonic()
+            while sent == nil or n < sent do
+                lt.assertEquals(time.monotonic() - start < 5000, true)
+                for op, token, status, bytes in as:wait(1) do
+                    lt.assertEquals(op, async.OP_SENDFILE)
+                    lt.assertEquals(token, "sendfile")
+                    lt.assertEquals(status, SUCCESS)
+                    sent = bytes
+                end
+                local data = cfd:recv()
+                if data then
+                    got[#got + 1] = data
+                    n = n + #data
+                end
+            end
+            lt.assertEquals(sent, #expected)
+            lt.assertEquals(table.concat(got) == expected, true)
+        end
+
+        transfer(nil, nil, content)
+        transfer(100, 1000, content:sub(101, 1100))
+        -- len 超过文件末尾时只发送到文件末尾
+        transfer(#content - 10, 4096, content:sub(-10))
+
+        lt.assertError(as.submit_sendfile, as, newfd, f, #content, nil, "empty")
+        lt.assertError(as.submit_sendfile, as, newfd, f, -1, 10, "negative")
+        f:close()
+        fs.remove(filepath)
+    end
+
+    --- 测试 relay：两个 socket 之间双向转发，EOF、limit 与 cancel
+    function m.test_relay()
+        local as <close> = assert(async.create(64))
+        local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+        local a1 <close> = SimpleClient(as, "tcp", sfd:info "socket")
+        local a2 <close> = wait_accept(as, sfd)
+        local b1 <close> = SimpleClient(as, "tcp", sfd:info "socket")
+        local b2 <close> = wait_accept(as, sfd)
+
+        local completions = {}
+        local function pump()
+            for op, token, status, bytes in as:wait(1) do
+                lt.assertEquals(op, async.OP_RELAY)
+                completions[token] = { status, bytes }
+            end
+        end
+        -- 从 from 发送 data，并在 to 上收齐
+        local function forward(from, to, data)
+            local got = {}
+            local n = 0
+            local pos = 1
+            local start = time.monotonic()
+            while n < #data do
+                lt.assertEquals(time.monotonic() - start < 5000, true)
+                if pos <= #data then
+                    local sent = from:send(data:sub(pos, pos + 65535))
+                    if sent then
+                        pos = pos + sent
+                    end
+                end
+                pump()
+                local s = to:recv()
+                if s then
+                    got[#got + 1] = s
+                    n = n + #s
+                end
+            end
+            lt.assertEquals(table.concat(got) == data, true)
+        end
+        local function wait_relay(token)
+            local start = time.monotonic()
+            while not completions[token] do
+                lt.assertEquals(time.monotonic() - start < 1000, true)
+                pump()
+            end
+            return table.unpack(completions[token])
+        end
+
+        lt.assertEquals(as:submit_relay(a2, b1, nil, "a->b"), true)
+        lt.assertEquals(as:submit_relay(b1, a2, nil, "b->a"), true)
+        local big = string.rep("0123456789abcdef", 16 * 1024)
+        forward(a1, b2, big)
+        forward(b2, a1, "pong")
+        forward(a1, b2, "ping")
+        lt.assertEquals(next(completions), nil)
+
+        -- src 遇到 EOF 时结束，返回转发的总字节数
+        a1:shutdown "w"
+        local status, bytes = wait_relay "a->b"
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(bytes, #big + 4)
+
+        -- cancel 任一端都会取消 relay
+        as:cancel(b1)
+        status, bytes = wait_relay "b->a"
+        lt.assertEquals(status, CANCEL)
+        lt.assertEquals(bytes, 4)
+
+        -- limit：只转发前 limit 个字节
+        lt.assertEquals(as:submit_relay(b1, a2, { limit = 10 }, "limit"), true)
+        forward(b2, a1, "0123456789")
+        b2:send "abcdef"
+        status, bytes = wait_relay "limit"
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(bytes, 10)
+        lt.assertError(as.submit_relay, as, b1, a2, { limit = 0 }, "bad")
+    end
+
+    function m.test_udp_sendto_recvfrom()
+        local as <close> = assert(async.create(64))
+        local a <close> = assert(socket.create "udp")
+        local b <close> = assert(socket.create "udp")
+        assert(as:associate(a))
+        assert(as:associate(b))
+        assert(a:bind("127.0.0.1", 0))
+        assert(b:bind("127.0.0.1", 0))
+        local a_ep = a:info "socket"
+        local b_ep = b:info "socket"
+
+        local from = socket.endpoint("inet", "0.0.0.0", 0)
+        lt.assertEquals(as:submit_recvfrom(b, from, 16, "recv"), true)
+        lt.assertEquals(as:submit_sendto(a, "hello", b_ep, "send"), true)
+        local got = {}
+        local start = time.monotonic()
+        while not (got.recv and got.send) do
+            lt.assertEquals(time.monotonic() - start < 1000, true)
+            for op, token, status, data in as:wait(10) do
+                got[token] = { op, status, data }
+            end
+        end
+        lt.assertEquals(got.send, { async.OP_SENDTO, SUCCESS, 5 })
+        lt.assertEquals(got.recv, { async.OP_RECVFROM, SUCCESS, "hello" })
+        lt.assertEquals(from, a_ep)
+
+        -- 超出 size 的部分被截断；已 connect 的 socket 可以不传 ep
+        assert(a:connect(b_ep))
+        lt.assertEquals(as:submit_sendto(a, "0123456789abcdefXYZ", nil, "send"), true)
+        lt.assertEquals(as:submit_recvfrom(b, from, 16, "recv"), true)
+        got = {}
+        start = time.monotonic()
+        while not (got.recv and got.send) do
+            lt.assertEquals(time.monotonic() - start < 1000, true)
+            for op, token, status, data in as:wait(10) do
+                got[token] = { op, status, data }
+            end
+        end
+        lt.assertEquals(got.send, { async.OP_SENDTO, SUCCESS, 19 })
+        lt.assertEquals(got.recv, { async.OP_RECVFROM, SUCCESS, "0123456789abcdef" })
+
+        -- 未完成的 recvfrom 可以被取消
+        lt.assertEquals(as:submit_recvfrom(b, from, 16, "recv"), true)
+        as:cancel(b)
+        local op, token, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_RECVFROM)
+        lt.assertEquals(token, "recv")
+        lt.assertEquals(status, CANCEL)
+    end
+
+    function m.test_udp_gso_gro()
+        local as <close> = assert(async.create(64))
+        local a <close> = assert(socket.create "udp")
+        local b <close> = assert(socket.create "udp")
+        assert(as:associate(a))
+        assert(as:associate(b))
+        assert(a:bind("127.0.0.1", 0))
+        assert(b:bind("127.0.0.1", 0))
+        assert(b:option("udp_gro", 1))
+        local b_ep = b:info "socket"
+
+        local payload = string.rep("a", 64) .. string.rep("b", 64) .. string.rep("c", 10)
+        local from = socket.endpoint("inet", "0.0.0.0", 0)
+        lt.assertEquals(as:submit_recvfrom(b, from, 65535, "recv"), true)
+        lt.assertEquals(as:submit_sendto(a, payload, b_ep, "send", 64), true)
+        local got = {}
+        local start = time.monotonic()
+        while not (got.recv and got.send) do
+            lt.assertEquals(time.monotonic() - start < 1000, true)
+            for op, token, status, data, _, segsize in as:wait(10) do
+                got[token] = { op, status, data, segsize }
+            end
+        end
+        lt.assertEquals(got.send, { async.OP_SENDTO, SUCCESS, #payload })
+        lt.assertEquals(got.recv, { async.OP_RECVFROM, SUCCESS, payload, 64 })
+        lt.assertError(as.submit_sendto, as, a, payload, b_ep, "bad", 65536)
+    end
+
+    function m.test_edge_triggered()
+        -- max_completions 很小：放不下的完成事件要靠就绪缓存在下次 wait 时继续
+        local as <close> = assert(async.create { max_completions = 2, edge_triggered = true })
+        local sfd <close> = SimpleServer(as, "tcp", "127.0.0.1", 0)
+        local _, port = sfd:info "socket":value()
+        lt.assertEquals(as:submit_accept_multishot(sfd, "accept"), true)
+        local clients = {}
+        for i = 1, 5 do
+            clients[i] = SimpleClient(as, "tcp", "127.0.0.1", port)
+        end
+        local accepted = {}
+        local start = time.monotonic()
+        while #accepted < 5 do
+            lt.assertEquals(time.monotonic() - start < 1000, true)
+            for op, token, status, newfd in as:wait(10) do
+                lt.assertEquals(op, async.OP_ACCEPT)
+                lt.assertEquals(status, SUCCESS)
+                accepted[#accepted + 1] = newfd
+            end
+        end
+        as:cancel(sfd)
+        wait_completion(as)
+
+        -- 一次边沿之后，数据分两次读完：第二次读只能依赖就绪缓存
+        local newfd = accepted[1]
+        local rb = assert(async.readbuf(4))
+        clients[1]:send "abcdef"
+        lt.assertEquals(as:submit_read(rb, newfd, "read1"), true)
+        local op, token, status, bytes = wait_completion(as)
+        lt.assertEquals(token, "read1")
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(rb:read(bytes), ("abcdef"):sub(1, bytes))
+        local rest = ("abcdef"):sub(bytes + 1)
+        while #rest > 0 do
+            lt.assertEquals(as:submit_read(rb, newfd, "read2"), true)
+            op, token, status, bytes = wait_completion(as)
+            lt.assertEquals(token, "read2")
+            lt.assertEquals(status, SUCCESS)
+            lt.assertEquals(rb:read(bytes), rest:sub(1, bytes))
+            rest = rest:sub(bytes + 1)
+        end
+
+        -- 写方向与 deadline
+        local wb = assert(async.writebuf())
+        wb:write "pong"
+        lt.assertEquals(as:submit_write(wb, newfd, "write"), true)
+        op, token, status = wait_completion(as)
+        lt.assertEquals(token, "write")
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(clients[1]:recv(), "pong")
+        lt.assertEquals(as:submit_read(rb, newfd, "timeout", 10), true)
+        op, token, status = wait_completion(as)
+        lt.assertEquals(token, "timeout")
+        lt.assertEquals(status, TIMEOUT)
+
+        -- cancel 后关闭，新 socket 复用 fd 号也能正常收到事件
+        for i = 1, 5 do
+            as:cancel(accepted[i])
+            accepted[i]:close()
+            clients[i]:close()
+        end
+        local a, b = assert(socket.pair())
+        lt.assertEquals(as:submit_read(rb, b, "reuse"), true)
+        a:send "ok"
+        op, token, status, bytes = wait_completion(as)
+        lt.assertEquals(token, "reuse")
+        lt.assertEquals(status, SUCCESS)
+        lt.assertEquals(rb:read(bytes), "ok")
+        as:cancel(b)
+        a:close()
+        b:close()
+
+        -- 不 cancel 直接关闭：内核已撤销注册，复用 fd 号的新 socket 要重新注册
+        a, b = assert(socket.pair())
+        for _, pair in ipairs { { a, b }, { b, a } } do
+            lt.assertEquals(as:submit_read(rb, pair[1], "registered"), true)
+            pair[2]:send "x"
+            op, token, status, bytes = wait_completion(as)
+            lt.assertEquals(token, "registered")
+            lt.assertEquals(rb:read(bytes), "x")
+        end
+        a:close()
+        b:close()
+        a, b = assert(socket.pair())
+        for _, pair in ipairs { { a, b }, { b, a } } do
+            lt.assertEquals(as:submit_read(rb, pair[1], "renewed"), true)
+            pair[2]:send "y"
+            op, token, status, bytes = wait_completion(as)
+            lt.assertEquals(token, "renewed")
+            lt.assertEquals(status, SUCCESS)
+            lt.assertEquals(rb:read(bytes), "y")
+        end
+        as:cancel(a)
+        as:cancel(b)
+        a:close()
+        b:close()
+    end
+
+    --- 测试 mailbox：同线程 post，值作为 OP_POST completion 的 udata 返回
+    function m.test_mailbox()
+        local as <close> = assert(async.create(64))
+        lt.assertEquals(as:mailbox "test_mailbox", true)
+        lt.assertError(as.mailbox, as, "test_mailbox")
+        local other <close> = assert(async.create(64))
+        lt.assertError(other.mailbox, other, "test_mailbox")
+        lt.assertFailed("Can't query mailbox 'test_mailbox_none'", async.mailbox "test_mailbox_none")
+
+        local mb = assert(async.mailbox "test_mailbox")
+        lt.assertEquals(mb:post { a = 1, b = "x" }, true)
+        lt.assertEquals(mb:post "second", true)
+        lt.assertEquals(mb:post(nil), true)
+        local got = {}
+        local start = time.monotonic()
+        while #got < 3 and time.monotonic() - start < 1000 do
+            for op, value, status in as:wait(100) do
+                lt.assertEquals(op, async.OP_POST)
+                lt.assertEquals(status, SUCCESS)
+                got[#got + 1] = { value }
+            end
+        end
+        lt.assertEquals(got, { { { a = 1, b = "x" } }, { "second" }, {} })
+
+        -- 关闭后 post 失败，名字可被重新使用
+        mb:post "dropped"
+        as:stop()
+        lt.assertFailed("mailbox is closed", mb:post "late")
+        lt.assertFailed("Can't query mailbox 'test_mailbox'", async.mailbox "test_mailbox")
+        lt.assertEquals(other:mailbox "test_mailbox", true)
+    end
+
+    --- 测试 mailbox：stop 只丢弃未迭代的 post，其余 completion 仍可迭代
+    function m.test_mailbox_stop()
+        local thread = require "bee.thread"
+        local as <close> = assert(async.create(64))
+        lt.assertEquals(as:mailbox "test_mailbox_stop", true)
+        local mb = assert(async.mailbox "test_mailbox_stop")
+        lt.assertEquals(as:submit_timer(0, "t1") ~= nil, true)
+        lt.assertEquals(as:submit_timer(0, "t2") ~= nil, true)
+        lt.assertEquals(mb:post "p1", true)
+        lt.assertEquals(mb:post "p2", true)
+        thread.sleep(20)
+        local timers = {}
+        local it = as:wait(100)
+        local op, token = it()
+        if op == async.OP_TIMER then
+            timers[token] = true
+        end
+        as:stop()
+        for op, token in it do
+            lt.assertEquals(op, async.OP_TIMER)
+            timers[token] = true
+        end
+        lt.assertEquals(timers, { t1 = true, t2 = true })
+    end
+
+    --- 测试 mailbox：其他线程 post，阻塞中的 wait 被唤醒，顺序保持
+    function m.test_mailbox_thread()
+        local thread = require "bee.thread"
+        local as <close> = assert(async.create(16))
+        lt.assertEquals(as:mailbox "test_mailbox_thread", true)
+        local thd = thread.create([[
+            local async = require "bee.async"
+            local thread = require "bee.thread"
+            local mb = assert(async.mailbox(...))
+            thread.sleep(20)
+            for i = 1, 200 do
+                assert(mb:post(i))
+            end
+        ]], "test_mailbox_thread")
+        local n = 0
+        local start = time.monotonic()
+        while n < 200 do
+            lt.assertEquals(time.monotonic() - start < 5000, true)
+            for op, value, status in as:wait(-1) do
+                lt.assertEquals(op, async.OP_POST)
+                lt.assertEquals(status, SUCCESS)
+                n = n + 1
+                lt.assertEquals(value, n)
+            end
+        end
+        thread.wait(thd)
+        lt.assertEquals(thread.errlog(), nil)
+    end
+
+    --- 测试 stats：提交/完成计数与延迟直方图
+    function m.test_stats()
+        local as <close> = assert(async.create(64))
+        local st = as:stats()
+        lt.assertEquals(st.ops, {})
+        lt.assertEquals(st.inflight, 0)
+        roundtrip(as)
+        lt.assertEquals(as:submit_timer(1, "timer") ~= nil, true)
+        lt.assertEquals(as:stats().inflight, 1)
+        local op, token, status = wait_completion(as)
+        lt.assertEquals(op, async.OP_TIMER)
+        lt.assertEquals(token, "timer")
+        lt.assertEquals(status, SUCCESS)
+
+        st = as:stats()
+        lt.assertEquals(st.inflight, 0)
+        lt.assertEquals(st.submit_failures, 0)
+        lt.assertEquals(st.enter_calls + st.wait_calls > 0, true)
+        for _, o in ipairs { async.OP_WRITE, async.OP_READ, async.OP_TIMER } do
+            local s = st.ops[o]
+            lt.assertEquals(s.submits, 1)
+            lt.assertEquals(s.completions, 1)
+            local sum = 0
+            for _, n in ipairs(s.latency) do
+                sum = sum + n
+            end
+            lt.assertEquals(sum, 1)
+        end
+        -- 定时器至少等待 1000us，落在第 11 个桶 [512us, 1024us) 或更慢的桶
+        lt.assertEquals(#st.ops[async.OP_TIMER].latency >= 11, true)
+        as:stop()
+        lt.assertEquals(as:stats().ops, {})
+    end
+
+    --- 测试小数毫秒超时：wait 不再按整毫秒睡眠
+    function m.test_wait_fractional()
+        local as <close> = assert(async.create(64))
+        -- 按整毫秒取整时每轮至少 10ms；取最快一轮以避开调度抖动
+        local fastest = math.huge
+        for _ = 1, 5 do
+            local start = time.monotonic()
+            for _ = 1, 10 do
+                for _ in as:wait(0.1) do
+                    lt.failure("unexpected completion")
+                end
+            end
+            fastest = math.min(fastest, time.monotonic() - start)
+        end
+        lt.assertEquals(fastest < 10, true)
+        lt.assertEquals(as:wait_into({}, 0.1), 0)
+        lt.assertEquals(as:submit_timer(1, "timer") ~= nil, true)
+        local got
+        local start = time.monotonic()
+        while not got and time.monotonic() - start < 1000 do
+            for op, token in as:wait(0.25) do
+                lt.assertEquals(op, async.OP_TIMER)
+                got = token
+            end
+        end
+        lt.assertEquals(got, "timer")
+    end
+
+    --- 测试 busy_poll：wait 先自旋再阻塞，stats 记录两者耗时
+    function m.test_busy_poll()
+        local as <close> = assert(async.create { busy_poll = 200 })
+        roundtrip(as)
+        for _ in as:wait(1) do
+            lt.failure("unexpected completion")
+        end
+        lt.assertEquals(as:submit_timer(2, "timer") ~= nil, true)
+        local op, token = wait_completion(as)
+        lt.assertEquals(op, async.OP_TIMER)
+        lt.assertEquals(token, "timer")
+        local st = as:stats()
+        lt.assertEquals(st.spin_ns > 0, true)
+        lt.assertEquals(st.block_ns > 0, true)
+
+        local plain <close> = assert(async.create(64))
+        roundtrip(plain)
+        st = plain:stats()
+        lt.assertEquals(st.spin_ns, 0)
+        lt.assertEquals(st.spin_hits, 0)
+    end
+end
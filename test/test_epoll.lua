@@ -2,6 +2,7 @@ local lt = require "ltest"
 local epoll = require "bee.epoll"
 local socket = require "bee.socket"
 local time = require "bee.time"
+local platform = require "bee.platform"
 local m = lt.test "epoll"
 
 local function SimpleServer(protocol, ...)
@@ -91,6 +92,56 @@ function m.test_wait()
     end
 end
 
+function m.test_wait_fractional()
+    local epfd <close> = epoll.create(16)
+    local sfd <close> = SimpleServer("tcp", "127.0.0.1", 0)
+    epfd:event_add(sfd, epoll.EPOLLIN, "server")
+    lt.assertError(epfd.wait, epfd, "x")
+    if platform.os == "linux" or platform.os == "macos" then
+        -- 按整毫秒取整时每轮至少 10ms；取最快一轮以避开调度抖动
+        local fastest = math.huge
+        for _ = 1, 5 do
+            local start = time.monotonic()
+            for _ = 1, 10 do
+                for _ in epfd:wait(0.1) do
+                    lt.failure "Shouldn't run to here."
+                end
+            end
+            fastest = math.min(fastest, time.monotonic() - start)
+        end
+        lt.assertEquals(fastest < 10, true)
+    end
+    local cfd <close> = SimpleClient("tcp", sfd:info "socket")
+    local got
+    for _ = 1, 100 do
+        for ud in epfd:wait(10.5) do
+            got = ud
+        end
+        if got then break end
+    end
+    lt.assertEquals(got, "server")
+end
+
+function m.test_busy_poll()
+    lt.assertFailed("busy_poll is out of range.", epoll.create(16, -1))
+    local epfd <close> = epoll.create(16, 200)
+    local sfd <close> = SimpleServer("tcp", "127.0.0.1", 0)
+    epfd:event_add(sfd, epoll.EPOLLIN, "server")
+    for _ in epfd:wait(1) do
+        lt.failure "Shouldn't run to here."
+    end
+    local cfd <close> = SimpleClient("tcp", sfd:info "socket")
+    local got
+    for _ = 1, 100 do
+        for ud, event in epfd:wait(10) do
+            got = ud
+            lt.assertEquals(event & epoll.EPOLLIN, epoll.EPOLLIN)
+        end
+        if got then break end
+    end
+    lt.assertEquals(got, "server")
+end
+
 local events = {
     "EPOLLIN",
     "EPOLLPRI",
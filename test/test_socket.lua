@@ -3,6 +3,7 @@ local socket = require "bee.socket"
 local select = require "bee.select"
 local thread = require "bee.thread"
 local fs = require "bee.filesystem"
+local platform = require "bee.platform"
 
 local function simple_select(fd, mode)
     local s <close> = select.create()
@@ -424,6 +425,93 @@ function test_socket:test_udp()
     b_fd:close()
 end
 
+function test_socket:test_udp_mmsg()
+    local a_fd = lt.assertIsUserdata(socket.create "udp")
+    local b_fd = lt.assertIsUserdata(socket.create "udp")
+    lt.assertEquals(a_fd:bind("127.0.0.1", 0), true)
+    lt.assertEquals(b_fd:bind("127.0.0.1", 0), true)
+    local a_ep = a_fd:info "socket"
+    local b_ep = b_fd:info "socket"
+    local out = { "a", "", "ccc" }
+    lt.assertEquals(a_fd:sendmmsg(out, { b_ep, b_ep, b_ep }), 3)
+    lt.assertEquals(a_fd:sendmmsg(out, { b_ep }, 1), 1)
+    lt.assertErrorMsgEquals("msgs[2] is not a string", a_fd.sendmmsg, a_fd, { "a", 42 }, { b_ep, b_ep })
+    local msgs = {}
+    local eps = {}
+    for i = 1, 8 do
+        eps[i] = socket.endpoint("inet", "0.0.0.0", 0)
+    end
+    local got = 0
+    while got < 4 do
+        simple_select(b_fd, "r")
+        local n = lt.assertIsNumber(b_fd:recvmmsg(msgs, eps))
+        for i = 1, n do
+            lt.assertEquals(msgs[i], out[(got + i - 1) % 3 + 1])
+            lt.assertEquals(eps[i], a_ep)
+        end
+        got = got + n
+    end
+    lt.assertEquals(got, 4)
+    lt.assertEquals(b_fd:recvmmsg(msgs, eps), false)
+    a_fd:close()
+    b_fd:close()
+end
+
+if platform.os == "linux" then
+    function test_socket:test_udp_gso_gro()
+        local a_fd = lt.assertIsUserdata(socket.create "udp")
+        local b_fd = lt.assertIsUserdata(socket.create "udp")
+        local c_fd = lt.assertIsUserdata(socket.create "udp")
+        lt.assertEquals(a_fd:bind("127.0.0.1", 0), true)
+        lt.assertEquals(b_fd:bind("127.0.0.1", 0), true)
+        lt.assertEquals(c_fd:bind("127.0.0.1", 0), true)
+        local b_ep = b_fd:info "socket"
+        local c_ep = c_fd:info "socket"
+        local payload = string.rep("x", 100) .. string.rep("y", 100) .. string.rep("z", 50)
+        lt.assertEquals(a_fd:option("udp_segment", 100), true)
+        lt.assertEquals(c_fd:option("udp_gro", 1), true)
+
+        -- 未开启 GRO：内核按分段大小拆成多个数据报
+        lt.assertEquals(a_fd:sendto(payload, b_ep), #payload)
+        local msgs, eps, segs = {}, {}, {}
+        for i = 1, 4 do
+            eps[i] = socket.endpoint("inet", "0.0.0.0", 0)
+        end
+        local got = {}
+        while #got < 3 do
+            simple_select(b_fd, "r")
+            local n = lt.assertIsNumber(b_fd:recvmmsg(msgs, eps, nil, segs))
+            for i = 1, n do
+                got[#got + 1] = msgs[i]
+                lt.assertEquals(segs[i], 0)
+            end
+        end
+        lt.assertEquals(got, { payload:sub(1, 100), payload:sub(101, 200), payload:sub(201) })
+
+        -- 开启 GRO：一次接收整个缓冲区，并返回分段大小
+        lt.assertEquals(a_fd:sendto(payload, c_ep), #payload)
+        simple_select(c_fd, "r")
+        local data, _, segsize = c_fd:recvfrom(65535)
+        lt.assertEquals(data, payload)
+        lt.assertEquals(segsize, 100)
+
+        a_fd:close()
+        b_fd:close()
+        c_fd:close()
+    end
+
+    function test_socket:test_busy_poll_option()
+        local fd = lt.assertIsUserdata(socket.create "udp")
+        lt.assertEquals(fd:option("busy_poll", 0), true)
+        -- 超过 net.core.busy_read 需要 CAP_NET_ADMIN
+        local ok, err = fd:option("busy_poll", 50)
+        if not ok then
+            lt.assertEquals(err:match "setsockopt" ~= nil, true)
+        end
+        fd:close()
+    end
+end
+
 function test_socket:test_udp_unreachable()
     local a_fd = lt.assertIsUserdata(socket.create "udp")
     local b_fd = lt.assertIsUserdata(socket.create "udp")